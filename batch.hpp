@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <iostream>
+
+// Lazily reads one username per line from a file, or from stdin for "-".
+// Blank lines and lines starting with '#' are skipped; surrounding
+// whitespace (including CR from Windows line endings) is trimmed.
+class UsernameReader {
+private:
+    std::ifstream file;
+    std::istream* in;
+    size_t lineNumber;
+
+public:
+    explicit UsernameReader(const std::string& path)
+        : in(nullptr), lineNumber(0) {
+        if (path == "-") {
+            in = &std::cin;
+        } else {
+            file.open(path);
+            if (file.is_open()) in = &file;
+        }
+    }
+
+    bool isOpen() const { return in != nullptr; }
+    size_t line() const { return lineNumber; }
+
+    bool next(std::string& username) {
+        if (!in) return false;
+
+        std::string lineText;
+        while (std::getline(*in, lineText)) {
+            lineNumber++;
+            size_t start = lineText.find_first_not_of(" \t\r");
+            if (start == std::string::npos || lineText[start] == '#') continue;
+            size_t end = lineText.find_last_not_of(" \t\r");
+            username = lineText.substr(start, end - start + 1);
+            return true;
+        }
+        return false;
+    }
+};
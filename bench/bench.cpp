@@ -0,0 +1,261 @@
+// Engine benchmark: runs users x platforms checks against simulated hosts
+// and reports throughput and latency percentiles for each engine
+// configuration. The "fake" transport measures the engine alone; the
+// "curl" transport goes through libcurl to a local mock HTTP server that
+// answers for every platform host via CURLOPT_CONNECT_TO.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <cstdlib>
+#include "engine.hpp"
+#include "fake_transport.hpp"
+#include "platforms.hpp"
+#include "mock_server.hpp"
+
+struct BenchConfig {
+    std::string name;
+    int concurrency;
+    bool adaptive;   // LatencyTracker-sized timeouts
+    bool hedge;
+};
+
+struct BenchResult {
+    size_t checks = 0;
+    size_t errors = 0;
+    double wallSeconds = 0;
+    std::vector<double> latencies;
+    std::map<std::string, size_t> statuses;
+    size_t hedges = 0;
+    size_t retries = 0;
+};
+
+static double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t index = std::min(sorted.size() - 1, (size_t)(q * sorted.size()));
+    return sorted[index];
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --users N            Usernames per run (default: 50)\n"
+              << "  --latency MS         Median response time (default: 50)\n"
+              << "  --tail MS            p99 response time, 0 for constant latency (default: 400)\n"
+              << "  --errors RATE        Fraction of requests that fail (default: 0.01)\n"
+              << "  --found RATE         Fraction of URLs answered with 200 (default: 0.3)\n"
+              << "  --profile HOST:LAT:TAIL:ERR  Override the latency profile of one host (repeatable)\n"
+              << "  --transport T        fake, curl or both (default: both)\n"
+              << "  --rate N             Requests per second per host (default: 1000)\n"
+              << "  --timeout SECONDS    Per-request timeout (default: 5)\n"
+              << "  --seed N             Random seed (default: 1)\n";
+}
+
+// Every platform of the built-in database, over plain HTTP since the mock
+// server does not speak TLS
+static bool loadPlatforms(PlatformTable& platforms) {
+    std::string text = DEFAULT_PLATFORM_DB;
+    for (size_t at = 0; (at = text.find("https://", at)) != std::string::npos;) {
+        text.replace(at, 8, "http://");
+    }
+    std::string error;
+    if (!platforms.loadText(text, "<bench>", error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static BenchResult runOnce(std::unique_ptr<Transport> transport, const EngineOptions& options, const BenchConfig& config,
+                           const PlatformTable& platforms, size_t users) {
+    CheckEngine engine(options, std::move(transport));
+    LatencyTracker tracker;
+    if (config.adaptive || config.hedge) engine.setLatency(&tracker);
+
+    BenchResult result;
+    if (!engine.ready()) {
+        std::cerr << "Error: transport could not be initialized" << std::endl;
+        return result;
+    }
+    result.latencies.reserve(users * platforms.size());
+
+    size_t user = 0;
+    size_t index = platforms.size();
+    std::string username;
+    auto next = [&](CheckJob& job) {
+        if (index == platforms.size()) {
+            if (user == users) return false;
+            username = "benchuser" + std::to_string(user++);
+            index = 0;
+        }
+        const Platform& platform = platforms[index++];
+        platform.buildURL(username, job.url);
+        job.platform = platform.name;
+        job.host = platform.host;
+        job.rule = &platform.rule;
+        job.user = user;
+        return true;
+    };
+
+    auto started = std::chrono::steady_clock::now();
+    engine.run(next, [&](const CheckOutcome& outcome) {
+        result.checks++;
+        if (outcome.error != CURLE_OK) {
+            result.errors++;
+            result.statuses["error"]++;
+            return;
+        }
+        result.latencies.push_back(outcome.seconds);
+        result.statuses[std::to_string(outcome.responseCode)]++;
+    });
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    result.hedges = engine.hedgeCount();
+    result.retries = engine.retryCount();
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+static void printResult(const std::string& transport, const BenchConfig& config, const BenchResult& result) {
+    std::string statuses;
+    for (const auto& entry : result.statuses) {
+        if (!statuses.empty()) statuses += " ";
+        statuses += entry.first + ":" + std::to_string(entry.second);
+    }
+    double rate = result.wallSeconds > 0 ? result.checks / result.wallSeconds : 0.0;
+    std::cout << std::left << std::setw(8) << transport << std::setw(16) << config.name << std::right << std::fixed
+              << std::setw(8) << result.checks << std::setw(9) << std::setprecision(2) << result.wallSeconds
+              << std::setw(10) << std::setprecision(0) << rate << std::setw(9) << std::setprecision(1)
+              << percentile(result.latencies, 0.50) * 1000 << std::setw(9) << percentile(result.latencies, 0.99) * 1000
+              << std::setw(7) << result.errors << std::setw(7) << result.hedges << std::setw(7) << result.retries << "  "
+              << statuses << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    size_t users = 50;
+    FakeHostProfile profile;
+    profile.latencyMs = 50;
+    profile.tailMs = 400;
+    profile.errorRate = 0.01;
+    profile.foundRate = 0.3;
+    std::map<std::string, FakeHostProfile> overrides;
+    std::string transports = "both";
+    double rate = 1000;
+    int timeout = 5;
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--users" && hasValue) {
+            users = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--latency" && hasValue) {
+            profile.latencyMs = std::atof(argv[++i]);
+        } else if (arg == "--tail" && hasValue) {
+            profile.tailMs = std::atof(argv[++i]);
+        } else if (arg == "--errors" && hasValue) {
+            profile.errorRate = std::atof(argv[++i]);
+        } else if (arg == "--found" && hasValue) {
+            profile.foundRate = std::atof(argv[++i]);
+        } else if (arg == "--profile" && hasValue) {
+            // HOST:LATENCY:TAIL:ERRORS, unspecified fields keep the defaults
+            std::string spec = argv[++i];
+            std::vector<std::string> fields;
+            std::stringstream split(spec);
+            for (std::string field; std::getline(split, field, ':');) fields.push_back(field);
+            if (fields.empty() || fields[0].empty()) {
+                std::cerr << "Error: --profile expects HOST:LATENCY:TAIL:ERRORS" << std::endl;
+                return 1;
+            }
+            FakeHostProfile custom = profile;
+            if (fields.size() > 1) custom.latencyMs = std::atof(fields[1].c_str());
+            if (fields.size() > 2) custom.tailMs = std::atof(fields[2].c_str());
+            if (fields.size() > 3) custom.errorRate = std::atof(fields[3].c_str());
+            overrides[fields[0]] = custom;
+        } else if (arg == "--transport" && hasValue) {
+            transports = argv[++i];
+        } else if (arg == "--rate" && hasValue) {
+            rate = std::atof(argv[++i]);
+        } else if (arg == "--timeout" && hasValue) {
+            timeout = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "Error: unknown or incomplete option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (transports != "fake" && transports != "curl" && transports != "both") {
+        std::cerr << "Error: --transport must be fake, curl or both" << std::endl;
+        return 1;
+    }
+    if (users == 0 || rate <= 0 || timeout <= 0) {
+        std::cerr << "Error: --users, --rate and --timeout must be positive" << std::endl;
+        return 1;
+    }
+
+    PlatformTable platforms;
+    if (!loadPlatforms(platforms)) return 1;
+
+    const std::vector<BenchConfig> configs = {
+        {"c20", 20, false, false},
+        {"c100", 100, false, false},
+        {"c100-adaptive", 100, true, false},
+        {"c100-hedge", 100, true, true},
+    };
+
+    MockServer server(profile);
+    std::vector<std::string> connectTo;
+    if (transports != "fake") {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        for (const auto& entry : overrides) server.setProfile(entry.first, entry.second);
+        if (!server.start()) {
+            std::cerr << "Error: could not start the mock server" << std::endl;
+            return 1;
+        }
+        // Route every host to the mock server; the Host header still names the platform
+        connectTo.push_back("::127.0.0.1:" + std::to_string(server.port()));
+    }
+
+    std::cout << users << " users x " << platforms.size() << " platforms, latency p50 " << profile.latencyMs << " ms / p99 "
+              << std::max(profile.tailMs, profile.latencyMs) << " ms, errors " << profile.errorRate << ", found "
+              << profile.foundRate << "\n\n";
+    std::cout << std::left << std::setw(8) << "backend" << std::setw(16) << "config" << std::right << std::setw(8) << "checks"
+              << std::setw(9) << "wall s" << std::setw(10) << "checks/s" << std::setw(9) << "p50 ms" << std::setw(9)
+              << "p99 ms" << std::setw(7) << "errors" << std::setw(7) << "hedges" << std::setw(7) << "retry"
+              << "  statuses\n";
+
+    for (const auto& config : configs) {
+        EngineOptions options;
+        options.concurrency = config.concurrency;
+        options.timeout = timeout;
+        options.hostRate = rate;
+        options.hostBurst = rate;
+        options.http2 = false;
+        options.hedge = config.hedge;
+        options.connectTo = connectTo;
+
+        if (transports != "curl") {
+            std::unique_ptr<FakeTransport> fake(new FakeTransport(config.concurrency, profile, seed));
+            for (const auto& entry : overrides) fake->setProfile(entry.first, entry.second);
+            printResult("fake", config, runOnce(std::move(fake), options, config, platforms, users));
+        }
+        if (transports != "fake") {
+            std::unique_ptr<Transport> curl(new CurlTransport(config.concurrency, options.http2, options.maxStreams, connectTo));
+            printResult("curl", config, runOnce(std::move(curl), options, config, platforms, users));
+        }
+    }
+
+    if (transports != "fake") {
+        server.stop();
+        curl_global_cleanup();
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "fake_transport.hpp"
+
+// Minimal HTTP/1.1 server on 127.0.0.1 for the benchmark. Every request is
+// answered according to the FakeHostProfile of its Host header, so one
+// server stands in for every platform once the client routes all hosts to
+// it (CURLOPT_CONNECT_TO "::127.0.0.1:PORT"). One thread per connection,
+// keep-alive supported; an "error" closes the connection without answering.
+class MockServer {
+private:
+    int listener;
+    int boundPort;
+    std::atomic<bool> stopping;
+    std::thread acceptor;
+    std::mutex mutex;
+    std::vector<std::thread> workers;
+    std::vector<int> clients;
+    FakeHostProfile fallback;
+    std::map<std::string, FakeHostProfile> profiles;
+    std::atomic<size_t> served;
+
+    const FakeHostProfile& profileFor(const std::string& host) const {
+        auto found = profiles.find(host);
+        return found == profiles.end() ? fallback : found->second;
+    }
+
+    static std::string headerValue(const std::string& request, const char* name) {
+        std::string lower = request;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        std::string key = std::string("\r\n") + name + ":";
+        size_t at = lower.find(key);
+        if (at == std::string::npos) return "";
+        size_t start = request.find_first_not_of(' ', at + key.size());
+        size_t end = request.find("\r\n", start);
+        return request.substr(start, end - start);
+    }
+
+    void serve(int client, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::string buffer;
+        char chunk[4096];
+
+        while (!stopping) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t got = recv(client, chunk, sizeof(chunk), 0);
+                if (got <= 0) return;
+                buffer.append(chunk, got);
+            }
+            std::string request = buffer.substr(0, headerEnd + 2);
+            buffer.erase(0, headerEnd + 4);
+
+            size_t methodEnd = request.find(' ');
+            size_t pathEnd = request.find(' ', methodEnd + 1);
+            if (methodEnd == std::string::npos || pathEnd == std::string::npos) return;
+            std::string method = request.substr(0, methodEnd);
+            std::string path = request.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+            std::string host = headerValue(request, "host");
+            const FakeHostProfile& profile = profileFor(urlHost("http://" + host));
+
+            std::this_thread::sleep_for(std::chrono::duration<double>(profile.sampleSeconds(rng)));
+            if (profile.sampleError(rng)) return;
+
+            // Same URL as the client built, so both backends agree on the status
+            long status = profile.statusFor("http://" + host + path);
+            const std::string& body = profile.body;
+            std::string response = "HTTP/1.1 " + std::to_string(status) + (status == 404 ? " Not Found" : " OK") +
+                                   "\r\nContent-Type: text/html\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+            if (method != "HEAD") response += body;
+
+            size_t sent = 0;
+            while (sent < response.size()) {
+                ssize_t wrote = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (wrote <= 0) return;
+                sent += wrote;
+            }
+            served++;
+        }
+    }
+
+    void acceptLoop() {
+        unsigned seed = 1;
+        while (!stopping) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) continue;
+            int on = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+            std::lock_guard<std::mutex> guard(mutex);
+            if (stopping) {
+                close(client);
+                break;
+            }
+            clients.push_back(client);
+            workers.emplace_back([this, client, seed] {
+                serve(client, seed);
+                shutdown(client, SHUT_RDWR);
+            });
+            seed++;
+        }
+    }
+
+public:
+    explicit MockServer(const FakeHostProfile& defaultProfile = FakeHostProfile())
+        : listener(-1), boundPort(0), stopping(false), fallback(defaultProfile), served(0) {}
+
+    ~MockServer() { stop(); }
+
+    MockServer(const MockServer&) = delete;
+    MockServer& operator=(const MockServer&) = delete;
+
+    // Behaviour for one host instead of the default; call before start()
+    void setProfile(const std::string& host, const FakeHostProfile& profile) { profiles[host] = profile; }
+
+    // Listen on an ephemeral port of 127.0.0.1
+    bool start() {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0) return false;
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 512) != 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            close(listener);
+            listener = -1;
+            return false;
+        }
+        boundPort = ntohs(address.sin_port);
+        acceptor = std::thread(&MockServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop() {
+        if (listener < 0) return;
+        stopping = true;
+        shutdown(listener, SHUT_RDWR);
+        acceptor.join();
+        close(listener);
+        listener = -1;
+
+        std::lock_guard<std::mutex> guard(mutex);
+        for (int client : clients) shutdown(client, SHUT_RDWR);
+        for (auto& worker : workers) worker.join();
+        for (int client : clients) close(client);
+        workers.clear();
+        clients.clear();
+    }
+
+    int port() const { return boundPort; }
+    size_t requestsServed() const { return served; }
+};
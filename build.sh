@@ -16,7 +16,7 @@ NC='\033[0m' # No Color
 SOURCES="main.cpp"
 
 # Common compiler flags
-COMMON_FLAGS="-std=c++17 -O2 -Wall -Wextra"
+COMMON_FLAGS="-std=c++17 -O2 -Wall -Wextra -pthread"
 
 # Package information
 PKG_IDENTIFIER="com.yougoldberg.osint"
@@ -93,7 +93,7 @@ build_windows() {
     if [ "$CURL_FOUND" = true ]; then
         # Build with libcurl
         x86_64-w64-mingw32-g++ \
-            -std=c++17 -O2 -static \
+            -std=c++17 -O2 -static -pthread \
             -I"$MINGW_PREFIX/include" \
             -L"$MINGW_PREFIX/lib" \
             -o yougoldberg-windows.exe main.cpp \
@@ -103,7 +103,7 @@ build_windows() {
         # Build without libcurl (will show error but creates executable)
         echo -e "${YELLOW}⚠️  Building without libcurl - executable will not be functional${NC}"
         x86_64-w64-mingw32-g++ \
-            -std=c++17 -O2 -static \
+            -std=c++17 -O2 -static -pthread \
             -o yougoldberg-windows.exe main.cpp \
             -static-libgcc -static-libstdc++ \
             -DNO_CURL
@@ -5,7 +5,7 @@ set -e
 echo "🔧 Building yougoldberg binary..."
 
 mkdir -p build
-g++ -std=c++17 -O2 -Wall -Wextra -o build/yougoldberg \
+g++ -std=c++17 -O2 -Wall -Wextra -pthread -o build/yougoldberg \
     main.cpp \
     $(pkg-config --cflags --libs libcurl)
 
@@ -0,0 +1,179 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <unordered_map>
+#include "hash.hpp"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Version of the on-disk cache format understood by this build
+#define RESULT_CACHE_VERSION 1
+
+
+// One fixed-size cache entry. The file is a 16-byte header followed by
+// these records; later records for the same key supersede earlier ones.
+struct CacheRecord {
+    uint64_t key;         // fnv1a64(platform + '\n' + username), seeded with the platform revision
+    int64_t checkedAt;    // unix time of the check
+    int32_t status;       // HTTP status
+    uint8_t found;        // detection verdict
+    uint8_t reserved[7];
+    uint32_t checksum;    // guards against torn appends
+
+    uint32_t computeChecksum() const {
+        std::string bytes(reinterpret_cast<const char*>(this), offsetof(CacheRecord, checksum));
+        return (uint32_t)fnv1a64(bytes);
+    }
+};
+static_assert(sizeof(CacheRecord) == 32, "cache records must stay 32 bytes");
+
+struct CacheHeader {
+    char magic[4];        // "YGRC"
+    uint32_t version;
+    uint64_t reserved;
+};
+static_assert(sizeof(CacheHeader) == 16, "cache header must stay 16 bytes");
+
+// Persistent (platform, username) -> verdict cache. The file is
+// memory-mapped and indexed once when opened; new results are appended as
+// whole records with O_APPEND, so several processes can read and write the
+// same cache concurrently without locking.
+class ResultCache {
+private:
+    int fd;
+    std::unordered_map<uint64_t, CacheRecord> index;
+    size_t lookups;
+    size_t hits;
+
+    // The platform's revision is part of the key, so a changed URL
+    // template or detection rule never gets verdicts made under the old one
+    static uint64_t keyFor(const std::string& platform, uint64_t revision, const std::string& username) {
+        return fnv1a64(username, fnv1a64(platform + "\n", revision));
+    }
+
+public:
+    ResultCache() : fd(-1), lookups(0), hits(0) {}
+
+    ~ResultCache() { close(); }
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    bool open(const std::string& directory, std::string& error) {
+#ifndef _WIN32
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            error = "could not create " + directory + ": " + strerror(errno);
+            return false;
+        }
+
+        std::string path = directory + "/results.cache";
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            error = "could not open " + path + ": " + strerror(errno);
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            error = "could not stat " + path + ": " + strerror(errno);
+            close();
+            return false;
+        }
+
+        if (info.st_size == 0) {
+            CacheHeader header = {{'Y', 'G', 'R', 'C'}, RESULT_CACHE_VERSION, 0};
+            if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+                error = "could not initialize " + path;
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            error = "could not map " + path + ": " + strerror(errno);
+            close();
+            return false;
+        }
+
+        const char* data = static_cast<const char*>(mapped);
+        const CacheHeader* header = reinterpret_cast<const CacheHeader*>(data);
+        if ((size_t)info.st_size < sizeof(CacheHeader) || memcmp(header->magic, "YGRC", 4) != 0 ||
+            header->version != RESULT_CACHE_VERSION) {
+            munmap(mapped, info.st_size);
+            error = path + " is not a version " + std::to_string(RESULT_CACHE_VERSION) + " result cache";
+            close();
+            return false;
+        }
+
+        // A trailing partial record (interrupted append) is simply ignored
+        size_t count = (info.st_size - sizeof(CacheHeader)) / sizeof(CacheRecord);
+        const CacheRecord* records = reinterpret_cast<const CacheRecord*>(data + sizeof(CacheHeader));
+        index.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            if (records[i].checksum != records[i].computeChecksum()) continue;
+            index[records[i].key] = records[i];
+        }
+
+        munmap(mapped, info.st_size);
+        return true;
+#else
+        error = "the result cache is not supported on this platform";
+        return false;
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+        fd = -1;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Fresh entry for (platform, username) no older than `maxAge` seconds;
+    // `revision` is Platform::revision
+    bool lookup(const std::string& platform, uint64_t revision, const std::string& username, long maxAge, CacheRecord& record) {
+        lookups++;
+        auto found = index.find(keyFor(platform, revision, username));
+        if (found == index.end()) return false;
+        if ((int64_t)time(nullptr) - found->second.checkedAt > maxAge) return false;
+
+        record = found->second;
+        hits++;
+        return true;
+    }
+
+    void store(const std::string& platform, uint64_t revision, const std::string& username, long status, bool found) {
+        if (fd < 0) return;
+
+        CacheRecord record;
+        memset(&record, 0, sizeof(record));
+        record.key = keyFor(platform, revision, username);
+        record.checkedAt = (int64_t)time(nullptr);
+        record.status = (int32_t)status;
+        record.found = found ? 1 : 0;
+        record.checksum = record.computeChecksum();
+
+#ifndef _WIN32
+        if (write(fd, &record, sizeof(record)) == (ssize_t)sizeof(record)) {
+            index[record.key] = record;
+        }
+#endif
+    }
+
+    size_t lookupCount() const { return lookups; }
+    size_t hitCount() const { return hits; }
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "curl_compat.hpp"
+#include "detect.hpp"
+
+// One URL to check, as handed to the engine
+struct CheckJob {
+    std::string platform;
+    std::string url;
+    std::string host;    // politeness key, see hostKey()
+    size_t user = 0;     // caller's tag for the username this job belongs to
+    bool connectOnly = false;  // warm DNS/TCP/TLS without sending a request
+    const DetectRule* rule = nullptr;  // how to judge the response; null means "200 is found"
+    uint64_t revision = 0;     // Platform::revision, part of the result cache key
+    bool fullTimeout = false;  // retry of an adaptive timeout: use the whole --timeout
+};
+
+// Where the time of one transfer went, from curl's phase timestamps.
+// Phases a transfer skipped (a reused connection, plain HTTP) stay 0.
+struct TransferTiming {
+    double dns = 0;        // name resolution
+    double connect = 0;    // TCP connect after resolution
+    double tls = 0;        // TLS handshake after connect
+    double ttfb = 0;       // request sent until the first response byte
+    long long bytes = 0;   // received, headers included
+};
+
+// Completion record for a CheckJob
+struct CheckOutcome {
+    CheckJob job;
+    CURLcode error;      // CURLE_OK when the transfer itself succeeded
+    long responseCode;   // HTTP status, 0 on transport failure
+    bool found;          // verdict of the job's DetectRule
+    double seconds;      // total transfer time
+    bool cached;         // answered from the result cache, no request sent
+    bool skipped;        // not sent because the host's circuit breaker is open
+    TransferTiming timing;
+    bool cancelled;      // dropped unanswered because the run's deadline passed
+};
@@ -0,0 +1,29 @@
+# Fails the build when the database compiled into platforms.hpp
+# (DEFAULT_PLATFORM_DB) differs from platforms.tsv. Both are edited by
+# hand; `yougoldberg --dump-platforms > platforms.tsv` brings the data
+# file in line with the header.
+#
+# cmake -DHEADER=platforms.hpp -DDATA=platforms.tsv -DSTAMP=file -P check_platform_db.cmake
+
+file(READ "${HEADER}" header)
+file(READ "${DATA}" data)
+
+set(open_marker "R\"DB(")
+set(close_marker ")DB\"")
+string(FIND "${header}" "${open_marker}" start)
+string(FIND "${header}" "${close_marker}" end)
+if(start EQUAL -1 OR end EQUAL -1 OR end LESS start)
+    message(FATAL_ERROR "${HEADER}: DEFAULT_PLATFORM_DB not found")
+endif()
+string(LENGTH "${open_marker}" marker_length)
+math(EXPR start "${start} + ${marker_length}")
+math(EXPR length "${end} - ${start}")
+string(SUBSTRING "${header}" ${start} ${length} builtin)
+
+if(NOT builtin STREQUAL data)
+    message(FATAL_ERROR "${DATA} and DEFAULT_PLATFORM_DB in ${HEADER} differ; update both, "
+                        "e.g. `yougoldberg --dump-platforms > platforms.tsv` after editing the header")
+endif()
+if(STAMP)
+    file(WRITE "${STAMP}" "")
+endif()
@@ -0,0 +1,154 @@
+#pragma once
+#ifdef NO_CURL
+// Stub curl functions for compilation without libcurl
+#include <cstdarg>
+#include <deque>
+#include <algorithm>
+
+typedef void CURL;
+typedef void CURLM;
+typedef void CURLSH;
+typedef int CURLcode;
+typedef int CURLMcode;
+typedef long long curl_off_t;
+#define CURLE_OK 0
+#define CURLE_COULDNT_RESOLVE_HOST 6
+#define CURLE_COULDNT_CONNECT 7
+#define CURLE_WRITE_ERROR 23
+#define CURLE_OPERATION_TIMEDOUT 28
+#define CURLM_OK 0
+#define CURLMSG_DONE 1
+#define CURL_GLOBAL_DEFAULT 0
+#define CURLOPT_URL 10000
+#define CURLOPT_NOBODY 44
+#define CURLOPT_HTTPGET 80
+#define CURLOPT_TIMEOUT 13
+#define CURLOPT_TIMEOUT_MS 155
+#define CURLOPT_USERAGENT 10018
+#define CURLOPT_FOLLOWLOCATION 52
+#define CURLOPT_SSL_VERIFYPEER 64
+#define CURLOPT_SSL_VERIFYHOST 81
+#define CURLOPT_WRITEFUNCTION 20011
+#define CURLOPT_WRITEDATA 10001
+#define CURLOPT_PRIVATE 10103
+#define CURLINFO_RESPONSE_CODE 2097154
+#define CURLOPT_SHARE 10100
+#define CURLOPT_CONNECT_ONLY 141
+#define CURLOPT_DNS_CACHE_TIMEOUT 92
+#define CURLOPT_HTTP_VERSION 84
+#define CURLOPT_PIPEWAIT 237
+#define CURLOPT_CONNECT_TO 10243
+#define CURL_HTTP_VERSION_1_1 2
+#define CURL_HTTP_VERSION_2_0 3
+#define CURL_HTTP_VERSION_2TLS 4
+#define CURL_HTTP_VERSION_3 30
+#define CURLMOPT_PIPELINING 3
+#define CURLMOPT_MAX_CONCURRENT_STREAMS 16
+#define CURLPIPE_MULTIPLEX 2L
+#define CURLINFO_PRIVATE 1048597
+#define CURLINFO_EFFECTIVE_URL 1048577
+#define CURLINFO_TOTAL_TIME_T 6291506
+#define CURLINFO_NAMELOOKUP_TIME_T 6291507
+#define CURLINFO_CONNECT_TIME_T 6291508
+#define CURLINFO_PRETRANSFER_TIME_T 6291509
+#define CURLINFO_STARTTRANSFER_TIME_T 6291510
+#define CURLINFO_APPCONNECT_TIME_T 6291512
+#define CURLINFO_SIZE_DOWNLOAD_T 6291464
+#define CURLINFO_HEADER_SIZE 2097163
+#define CURLINFO_LOCAL_PORT 2097194
+#define CURLINFO_HTTP_VERSION 2097198
+#define CURLINFO_NUM_CONNECTS 2097178
+#define CURLSHOPT_SHARE 1
+#define CURLSHOPT_LOCKFUNC 3
+#define CURLSHOPT_UNLOCKFUNC 4
+#define CURLSHOPT_USERDATA 5
+
+typedef enum {
+    CURL_LOCK_DATA_NONE = 0,
+    CURL_LOCK_DATA_SHARE,
+    CURL_LOCK_DATA_COOKIE,
+    CURL_LOCK_DATA_DNS,
+    CURL_LOCK_DATA_SSL_SESSION,
+    CURL_LOCK_DATA_CONNECT,
+    CURL_LOCK_DATA_LAST
+} curl_lock_data;
+typedef enum { CURL_LOCK_ACCESS_NONE = 0, CURL_LOCK_ACCESS_SHARED, CURL_LOCK_ACCESS_SINGLE } curl_lock_access;
+
+struct CURLMsg {
+    int msg;
+    CURL *easy_handle;
+    union {
+        void *whatever;
+        CURLcode result;
+    } data;
+};
+
+// Each stub handle only remembers its CURLOPT_PRIVATE pointer
+struct StubEasy { char *priv = nullptr; };
+struct StubMulti { std::deque<CURL*> done; CURLMsg msg; };
+
+CURL *curl_easy_init(void) { return new StubEasy(); }
+CURLcode curl_easy_setopt(CURL *curl, int option, ...) {
+    if (option == CURLOPT_PRIVATE) {
+        va_list args;
+        va_start(args, option);
+        static_cast<StubEasy*>(curl)->priv = va_arg(args, char*);
+        va_end(args);
+    }
+    return CURLE_OK;
+}
+CURLcode curl_easy_perform(CURL *curl) { return CURLE_OK; }
+CURLcode curl_easy_getinfo(CURL *curl, int info, ...) {
+    if (info == CURLINFO_PRIVATE) {
+        va_list args;
+        va_start(args, info);
+        *va_arg(args, char**) = static_cast<StubEasy*>(curl)->priv;
+        va_end(args);
+    }
+    return CURLE_OK;
+}
+void curl_easy_cleanup(CURL *curl) { delete static_cast<StubEasy*>(curl); }
+const char *curl_easy_strerror(CURLcode errornum) { return "OK"; }
+int curl_global_init(long flags) { return CURLE_OK; }
+void curl_global_cleanup(void) {}
+
+// Multi stubs complete every added transfer immediately with CURLE_OK
+CURLM *curl_multi_init(void) { return new StubMulti(); }
+CURLMcode curl_multi_cleanup(CURLM *multi) { delete static_cast<StubMulti*>(multi); return CURLM_OK; }
+CURLMcode curl_multi_setopt(CURLM *multi, int option, ...) { return CURLM_OK; }
+CURLMcode curl_multi_add_handle(CURLM *multi, CURL *easy) {
+    static_cast<StubMulti*>(multi)->done.push_back(easy);
+    return CURLM_OK;
+}
+CURLMcode curl_multi_remove_handle(CURLM *multi, CURL *easy) {
+    auto& done = static_cast<StubMulti*>(multi)->done;
+    done.erase(std::remove(done.begin(), done.end(), easy), done.end());
+    return CURLM_OK;
+}
+CURLMcode curl_multi_perform(CURLM *multi, int *running) { *running = 0; return CURLM_OK; }
+CURLMcode curl_multi_wakeup(CURLM *multi) { return CURLM_OK; }
+CURLMcode curl_multi_poll(CURLM *multi, void *fds, unsigned int nfds, int timeout_ms, int *numfds) {
+    if (numfds) *numfds = 0;
+    return CURLM_OK;
+}
+CURLMsg *curl_multi_info_read(CURLM *multi, int *msgs_in_queue) {
+    auto *m = static_cast<StubMulti*>(multi);
+    *msgs_in_queue = 0;
+    if (m->done.empty()) return nullptr;
+    m->msg.msg = CURLMSG_DONE;
+    m->msg.easy_handle = m->done.front();
+    m->msg.data.result = CURLE_OK;
+    m->done.pop_front();
+    *msgs_in_queue = static_cast<int>(m->done.size());
+    return &m->msg;
+}
+struct curl_slist { char *data; struct curl_slist *next; };
+struct curl_slist *curl_slist_append(struct curl_slist *list, const char *) { return list; }
+void curl_slist_free_all(struct curl_slist *) {}
+CURLSH *curl_share_init(void) { return nullptr; }
+int curl_share_setopt(CURLSH *share, int option, ...) { return CURLE_OK; }
+int curl_share_cleanup(CURLSH *share) { return CURLE_OK; }
+const char *curl_multi_strerror(CURLMcode errornum) { return "OK"; }
+#else
+#include <curl/curl.h>
+#endif
@@ -0,0 +1,210 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "curl_compat.hpp"
+#include "transport.hpp"
+#include "share.hpp"
+#include "scheduler.hpp"
+
+// Transport on top of the curl multi interface: one easy handle per slot,
+// all driven by a single multi handle.
+class CurlTransport : public Transport {
+private:
+    struct Slot {
+        CURL* easy;
+        size_t index;
+        const DetectRule* rule;
+        BodyScanner* scanner;
+        std::string host;
+        bool stopped;   // body aborted on purpose once the verdict was known
+        bool running;
+    };
+
+    CURLM* multi;
+    std::vector<Slot> handles;
+    ConnectionShare* share;
+    struct curl_slist* connectTo;
+
+    // Scan body chunks as they arrive and stop reading as soon as the
+    // verdict is settled; returning short makes curl end the transfer.
+    static size_t onBody(char* data, size_t size, size_t nmemb, void* userp) {
+        Slot* slot = static_cast<Slot*>(userp);
+        size_t total = size * nmemb;
+        if (!slot->rule || !slot->rule->needsBody()) return total;
+
+        long status = 0;
+        curl_easy_getinfo(slot->easy, CURLINFO_RESPONSE_CODE, &status);
+        if (!slot->rule->statusMatches(status) || slot->scanner->feed(data, total)) {
+            slot->stopped = true;
+            return 0;
+        }
+        return total;
+    }
+
+    // Turn curl's cumulative phase timestamps into per-phase durations
+    static void readTiming(CURL* easy, TransportResult& result) {
+        curl_off_t nameLookup = 0, connected = 0, appConnected = 0, preTransfer = 0, firstByte = 0, total = 0;
+        curl_off_t body = 0;
+        long headers = 0;
+        curl_easy_getinfo(easy, CURLINFO_NAMELOOKUP_TIME_T, &nameLookup);
+        curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME_T, &connected);
+        curl_easy_getinfo(easy, CURLINFO_APPCONNECT_TIME_T, &appConnected);
+        curl_easy_getinfo(easy, CURLINFO_PRETRANSFER_TIME_T, &preTransfer);
+        curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME_T, &firstByte);
+        curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME_T, &total);
+        curl_easy_getinfo(easy, CURLINFO_SIZE_DOWNLOAD_T, &body);
+        curl_easy_getinfo(easy, CURLINFO_HEADER_SIZE, &headers);
+
+        TransferTiming& timing = result.timing;
+        timing.dns = nameLookup / 1e6;
+        if (connected > nameLookup) timing.connect = (connected - nameLookup) / 1e6;
+        if (appConnected > connected) timing.tls = (appConnected - connected) / 1e6;
+        // From "about to send the request" to the first response byte; unlike
+        // the connect times this is also set on a reused connection
+        if (firstByte > preTransfer) timing.ttfb = (firstByte - preTransfer) / 1e6;
+        timing.bytes = body + headers;
+        result.seconds = total / 1e6;
+    }
+
+public:
+    // `overrides` are CURLOPT_CONNECT_TO entries ("HOST:PORT:ADDR:PORT"),
+    // which send requests for HOST to ADDR without changing the URL
+    CurlTransport(size_t slotCount, bool http2, long maxStreams, const std::vector<std::string>& overrides,
+                  ConnectionShare* sharedConnections = nullptr)
+        : multi(curl_multi_init()), handles(slotCount), share(sharedConnections), connectTo(nullptr) {
+        if (multi && http2) {
+            // Let transfers to the same host share one HTTP/2 connection
+            curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+            curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, maxStreams);
+        }
+        for (const auto& entry : overrides) {
+            connectTo = curl_slist_append(connectTo, entry.c_str());
+        }
+
+        for (size_t i = 0; i < handles.size(); i++) {
+            Slot& slot = handles[i];
+            slot.index = i;
+            slot.rule = nullptr;
+            slot.scanner = nullptr;
+            slot.stopped = false;
+            slot.running = false;
+            slot.easy = curl_easy_init();
+            if (!slot.easy) continue;
+            if (share) share->attach(slot.easy);
+
+            // Set common curl options
+            curl_easy_setopt(slot.easy, CURLOPT_WRITEFUNCTION, onBody);
+            curl_easy_setopt(slot.easy, CURLOPT_WRITEDATA, &slot);
+            curl_easy_setopt(slot.easy, CURLOPT_PRIVATE, &slot);
+            curl_easy_setopt(slot.easy, CURLOPT_FOLLOWLOCATION, 1L);
+            curl_easy_setopt(slot.easy, CURLOPT_USERAGENT, "Mozilla/5.0 (compatible; OSINT-CLI/1.0)");
+            curl_easy_setopt(slot.easy, CURLOPT_SSL_VERIFYPEER, 0L);
+            curl_easy_setopt(slot.easy, CURLOPT_SSL_VERIFYHOST, 0L);
+            if (connectTo) {
+                curl_easy_setopt(slot.easy, CURLOPT_CONNECT_TO, connectTo);
+            }
+            if (http2) {
+                curl_easy_setopt(slot.easy, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+                // Wait for a connection that can multiplex rather than opening another
+                curl_easy_setopt(slot.easy, CURLOPT_PIPEWAIT, 1L);
+            } else {
+                curl_easy_setopt(slot.easy, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_1_1);
+            }
+        }
+    }
+
+    ~CurlTransport() {
+        for (auto& slot : handles) {
+            if (slot.easy) {
+                curl_multi_remove_handle(multi, slot.easy);
+                curl_easy_cleanup(slot.easy);
+            }
+        }
+        if (multi) {
+            curl_multi_cleanup(multi);
+        }
+        if (connectTo) {
+            curl_slist_free_all(connectTo);
+        }
+    }
+
+    CurlTransport(const CurlTransport&) = delete;
+    CurlTransport& operator=(const CurlTransport&) = delete;
+
+    bool ready() const override {
+        if (!multi || handles.empty()) return false;
+        for (const auto& slot : handles) {
+            if (!slot.easy) return false;
+        }
+        return true;
+    }
+
+    size_t slots() const override { return handles.size(); }
+
+    void start(size_t index, const CheckJob& job, long timeoutMs, BodyScanner* scanner) override {
+        Slot& slot = handles[index];
+        slot.rule = job.rule;
+        slot.scanner = scanner;
+        slot.host = urlHost(job.url);
+        slot.stopped = false;
+        slot.running = true;
+
+        curl_easy_setopt(slot.easy, CURLOPT_URL, job.url.c_str());
+        curl_easy_setopt(slot.easy, CURLOPT_TIMEOUT_MS, timeoutMs);
+        curl_easy_setopt(slot.easy, CURLOPT_CONNECT_ONLY, job.connectOnly ? 1L : 0L);
+        if (job.rule && job.rule->needsBody()) {
+            curl_easy_setopt(slot.easy, CURLOPT_HTTPGET, 1L);
+        } else {
+            curl_easy_setopt(slot.easy, CURLOPT_NOBODY, 1L); // HEAD request only
+        }
+        curl_multi_add_handle(multi, slot.easy);
+    }
+
+    void cancel(size_t index) override {
+        Slot& slot = handles[index];
+        if (!slot.running) return;
+        curl_multi_remove_handle(multi, slot.easy);
+        slot.running = false;
+    }
+
+    int perform(std::vector<TransportResult>& done) override {
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+
+            Slot* slot = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&slot);
+            if (!slot->running) continue;   // cancelled while its message was queued
+
+            TransportResult result{slot->index, msg->data.result, 0, std::string(), 0.0, TransferTiming(), 0, 0, 0};
+            readTiming(slot->easy, result);
+            if (result.error == CURLE_WRITE_ERROR && slot->stopped) {
+                result.error = CURLE_OK;
+            }
+            if (result.error == CURLE_OK) {
+                char* finalURL = nullptr;
+                curl_easy_getinfo(slot->easy, CURLINFO_RESPONSE_CODE, &result.responseCode);
+                curl_easy_getinfo(slot->easy, CURLINFO_EFFECTIVE_URL, &finalURL);
+                curl_easy_getinfo(slot->easy, CURLINFO_HTTP_VERSION, &result.httpVersion);
+                curl_easy_getinfo(slot->easy, CURLINFO_LOCAL_PORT, &result.localPort);
+                if (finalURL) result.finalURL = finalURL;
+            }
+            curl_easy_getinfo(slot->easy, CURLINFO_NUM_CONNECTS, &result.newConnections);
+            if (share) share->recordTransfer(slot->host, result.newConnections);
+
+            curl_multi_remove_handle(multi, slot->easy);
+            slot->running = false;
+            done.push_back(std::move(result));
+        }
+        return running;
+    }
+
+    void wait(int waitMs) override {
+        curl_multi_poll(multi, nullptr, 0, std::max(1, waitMs), nullptr);
+    }
+
+    void wakeup() override { curl_multi_wakeup(multi); }
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DETECT_HAVE_SSE2 1
+#endif
+
+// Per-platform rule deciding whether a response means "profile exists".
+// Without body markers the check stays a HEAD request.
+struct DetectRule {
+    std::vector<long> statuses;   // statuses that count as found (default: 200)
+    std::string notFoundURL;      // final URL containing this text means not found
+    std::string foundMarker;      // body must contain this text
+    std::string notFoundMarker;   // body must not contain this text
+
+    bool needsBody() const { return !foundMarker.empty() || !notFoundMarker.empty(); }
+
+    bool statusMatches(long status) const {
+        if (statuses.empty()) return status == 200;
+        for (long expected : statuses) {
+            if (expected == status) return true;
+        }
+        return false;
+    }
+};
+
+// Find `needle` in `haystack`. On SSE2 targets this compares the first and
+// last needle byte against 16 candidate positions at once and only runs
+// memcmp where both match; elsewhere it falls back to memchr + memcmp.
+inline const char* findMarker(const char* haystack, size_t size, const char* needle, size_t length) {
+    if (length == 0) return haystack;
+    if (length > size) return nullptr;
+
+    size_t i = 0;
+#ifdef DETECT_HAVE_SSE2
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[length - 1]);
+    for (; i + length - 1 + 16 <= size; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + length - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                                                        _mm_cmpeq_epi8(blockLast, last)));
+        while (mask) {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, length > 2 ? length - 2 : 0) == 0) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    const char* end = haystack + size - length + 1;
+    for (const char* p = haystack + i; p < end; p++) {
+        p = static_cast<const char*>(memchr(p, needle[0], end - p));
+        if (!p) return nullptr;
+        if (memcmp(p, needle, length) == 0) return p;
+    }
+    return nullptr;
+}
+
+// Streams a response body through the rule's markers, keeping just enough
+// of the previous chunk to catch a marker split across two writes.
+class BodyScanner {
+private:
+    const DetectRule* rule;
+    std::string carry;
+    size_t seen;
+    size_t cap;
+
+    bool scan(const std::string& marker, const char* data, size_t size) {
+        if (marker.empty()) return false;
+
+        // Marker straddling the previous chunk and this one
+        if (!carry.empty()) {
+            std::string seam = carry + std::string(data, std::min(size, marker.size() - 1));
+            if (findMarker(seam.data(), seam.size(), marker.data(), marker.size())) return true;
+        }
+        return findMarker(data, size, marker.data(), marker.size()) != nullptr;
+    }
+
+public:
+    bool sawFound;
+    bool sawNotFound;
+
+    BodyScanner() : rule(nullptr), seen(0), cap(0), sawFound(false), sawNotFound(false) {}
+
+    void reset(const DetectRule* detectRule, size_t maxBytes) {
+        rule = detectRule;
+        carry.clear();
+        seen = 0;
+        cap = maxBytes;
+        sawFound = sawNotFound = false;
+    }
+
+    // Feed the next body chunk; returns true once the verdict can no longer
+    // change (or the byte cap is reached) and the transfer may be aborted.
+    bool feed(const char* data, size_t size) {
+        if (!rule) return false;
+
+        if (!sawNotFound && scan(rule->notFoundMarker, data, size)) sawNotFound = true;
+        if (!sawFound && scan(rule->foundMarker, data, size)) sawFound = true;
+        seen += size;
+
+        if (sawNotFound) return true;
+        if (sawFound && rule->notFoundMarker.empty()) return true;
+        if (cap > 0 && seen >= cap) return true;
+
+        size_t keep = std::max(rule->foundMarker.size(), rule->notFoundMarker.size());
+        keep = keep > 0 ? keep - 1 : 0;
+        if (size >= keep) {
+            carry.assign(data + size - keep, keep);
+        } else {
+            carry.append(data, size);
+            if (carry.size() > keep) carry.erase(0, carry.size() - keep);
+        }
+        return false;
+    }
+};
+
+// Final verdict for a completed (or deliberately aborted) transfer
+inline bool profileFound(const DetectRule* rule, long status, const std::string& finalURL, const BodyScanner& body) {
+    if (!rule) return status == 200;
+    if (!rule->statusMatches(status)) return false;
+    if (!rule->notFoundURL.empty() && finalURL.find(rule->notFoundURL) != std::string::npos) return false;
+    if (!rule->notFoundMarker.empty() && body.sawNotFound) return false;
+    if (!rule->foundMarker.empty() && !body.sawFound) return false;
+    return true;
+}
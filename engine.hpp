@@ -0,0 +1,341 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <map>
+#include <set>
+#include <memory>
+#include "curl_compat.hpp"
+#include "check_job.hpp"
+#include "scheduler.hpp"
+#include "share.hpp"
+#include "transport.hpp"
+#include "curl_transport.hpp"
+#include "health.hpp"
+#include "latency.hpp"
+
+// Tunables for CheckEngine
+struct EngineOptions {
+    int concurrency = 20;          // global cap on transfers in flight
+    int timeout = 10;              // per-transfer timeout in seconds
+    double hostRate = 2.0;         // requests per second per host
+    double hostBurst = 2.0;        // token bucket capacity per host
+    size_t maxPending = 1024;      // jobs pulled ahead of the scheduler
+    bool http2 = true;             // negotiate HTTP/2 over TLS and multiplex
+    long maxStreams = 100;         // concurrent streams per HTTP/2 connection
+    size_t maxBody = 256 * 1024;   // body bytes scanned for markers before giving up
+    bool hedge = false;            // duplicate requests that run past their host's p95
+    std::vector<std::string> connectTo;  // CURLOPT_CONNECT_TO host overrides
+};
+
+// Which HTTP versions a host answered with, and how many transfers shared
+// each connection. Connections are told apart by their local port.
+struct HostProtocolStats {
+    size_t transfers = 0;
+    size_t http1 = 0;
+    size_t http2 = 0;
+    size_t http3 = 0;
+    std::set<long> connections;
+
+    double streamsPerConnection() const {
+        return connections.empty() ? 0.0 : (double)transfers / connections.size();
+    }
+};
+
+// Event-driven check engine. Jobs are pulled lazily from a source callback
+// into a HostScheduler, which decides what may start; a Transport performs
+// them and completions are reported on the calling thread.
+class CheckEngine {
+private:
+    struct Transfer {
+        size_t slot;
+        CheckJob job;
+        BodyScanner scanner;
+        bool running;
+        bool isHedge;   // duplicate of a slow transfer, see launchHedges()
+        Transfer* twin; // the other copy while a hedged pair is racing
+        HostScheduler::Clock::time_point hedgeAt;
+        bool shortTimeout;  // ran with an adaptive timeout below --timeout
+    };
+
+    std::unique_ptr<Transport> transport;
+    std::vector<Transfer> transfers;
+    std::vector<Transfer*> idle;
+    std::vector<TransportResult> results;
+    HostScheduler scheduler;
+    HostHealth* health;
+    LatencyTracker* latency;
+    long timeout;
+    size_t maxPending;
+    size_t maxBody;
+    bool hedge;
+    size_t hedgesSent;
+    size_t hedgesWon;
+    size_t timeoutRetries;
+    HostScheduler::Clock::time_point deadline;
+    bool expired;
+    size_t cancelledChecks;
+    std::map<std::string, HostProtocolStats> protocols;
+
+    void recordProtocol(const Transfer* t, const TransportResult& result) {
+        HostProtocolStats& stats = protocols[urlHost(t->job.url)];
+        stats.transfers++;
+        if (result.httpVersion == CURL_HTTP_VERSION_3) stats.http3++;
+        else if (result.httpVersion == CURL_HTTP_VERSION_2_0) stats.http2++;
+        else stats.http1++;
+        if (result.localPort > 0) stats.connections.insert(result.localPort);
+    }
+
+    void start(Transfer* t, bool isHedge = false) {
+        t->scanner.reset(t->job.rule, maxBody);
+        t->running = true;
+        t->isHedge = isHedge;
+        t->twin = nullptr;
+        t->hedgeAt = HostScheduler::Clock::time_point::max();
+
+        long timeoutMs = timeout * 1000;
+        if (latency && !t->job.connectOnly) {
+            if (!t->job.fullTimeout) timeoutMs = latency->timeoutMs(t->job.host, timeoutMs);
+            double delay = 0;
+            if (hedge && !isHedge && latency->hedgeDelay(t->job.host, delay)) {
+                t->hedgeAt = HostScheduler::Clock::now() +
+                             std::chrono::duration_cast<HostScheduler::Clock::duration>(std::chrono::duration<double>(delay));
+            }
+        }
+        t->shortTimeout = timeoutMs < timeout * 1000;
+        transport->start(t->slot, t->job, timeoutMs, &t->scanner);
+    }
+
+    // Make a transfer available again; `cancel` drops a request still running
+    void finish(Transfer* t, bool cancel = false) {
+        if (cancel) transport->cancel(t->slot);
+        t->running = false;
+        scheduler.release();
+        idle.push_back(t);
+    }
+
+    // Start a duplicate of every transfer that has run past its host's p95,
+    // as soon as a transfer slot and a host token are free. The first copy
+    // to answer wins and the other is dropped. `wait` is lowered to the next
+    // hedge deadline that has not passed yet.
+    size_t launchHedges(HostScheduler::Clock::time_point now, HostScheduler::Clock::duration& wait) {
+        size_t launched = 0;
+        for (auto& t : transfers) {
+            if (!t.running || t.twin || t.isHedge || t.hedgeAt == HostScheduler::Clock::time_point::max()) continue;
+            if (t.hedgeAt > now) {
+                wait = std::min(wait, t.hedgeAt - now);
+                continue;
+            }
+
+            // Overdue: retried whenever the loop wakes up with a free slot
+            if (idle.empty() || !scheduler.take(t.job.host, now)) continue;
+
+            t.hedgeAt = HostScheduler::Clock::time_point::max();
+            Transfer* copy = idle.back();
+            idle.pop_back();
+            copy->job = t.job;
+            start(copy, true);
+            copy->twin = &t;
+            t.twin = copy;
+            hedgesSent++;
+            launched++;
+        }
+        return launched;
+    }
+
+    static CheckOutcome skippedOutcome(const CheckJob& job) {
+        return CheckOutcome{job, CURLE_OK, 0, false, 0.0, false, true, {}, false};
+    }
+
+    // The deadline passed: cancel every running transfer and drop every
+    // queued job, reporting each unanswered job once as cancelled
+    void abandon(const std::function<void(const CheckOutcome&)>& onDone) {
+        std::vector<CheckJob> unanswered;
+        for (auto& t : transfers) {
+            if (!t.running) continue;
+            // A racing hedged pair is one job; it is reported through the original
+            if (!(t.isHedge && t.twin)) unanswered.push_back(t.job);
+            finish(&t, true);
+        }
+        for (auto& t : transfers) t.twin = nullptr;
+        scheduler.drain(unanswered);
+
+        for (const CheckJob& job : unanswered) {
+            cancelledChecks++;
+            onDone(CheckOutcome{job, CURLE_OK, 0, false, 0.0, false, false, {}, true});
+        }
+    }
+
+    void init() {
+        for (size_t i = 0; i < transfers.size(); i++) {
+            transfers[i].slot = i;
+            transfers[i].running = false;
+            transfers[i].twin = nullptr;
+            idle.push_back(&transfers[i]);
+        }
+    }
+
+public:
+    // Engine on the curl transport
+    explicit CheckEngine(const EngineOptions& options = EngineOptions(), ConnectionShare* sharedConnections = nullptr)
+        : CheckEngine(options, std::unique_ptr<Transport>(new CurlTransport(
+              options.concurrency > 0 ? options.concurrency : 1, options.http2, options.maxStreams, options.connectTo,
+              sharedConnections))) {}
+
+    // Engine on any transport; concurrency is the transport's slot count
+    CheckEngine(const EngineOptions& options, std::unique_ptr<Transport> backend)
+        : transport(std::move(backend)), transfers(transport->slots()),
+          scheduler(options.hostRate, options.hostBurst, transfers.size()),
+          health(nullptr), latency(nullptr), timeout(options.timeout), maxPending(options.maxPending), maxBody(options.maxBody),
+          hedge(options.hedge), hedgesSent(0), hedgesWon(0), timeoutRetries(0),
+          deadline(HostScheduler::Clock::time_point::max()), expired(false), cancelledChecks(0) {
+        init();
+    }
+
+    CheckEngine(const CheckEngine&) = delete;
+    CheckEngine& operator=(const CheckEngine&) = delete;
+
+    bool ready() const { return transport->ready() && !idle.empty(); }
+
+    // Skip hosts whose circuit breaker is open and feed it every result
+    void setHealth(HostHealth* hostHealth) { health = hostHealth; }
+
+    // Size per-host timeouts (and hedge delays) from `tracker` and feed it
+    // the time of every successful check
+    void setLatency(LatencyTracker* tracker) { latency = tracker; }
+
+    size_t hedgeCount() const { return hedgesSent; }
+    size_t hedgeWins() const { return hedgesWon; }
+    size_t retryCount() const { return timeoutRetries; }
+
+    // Stop run() at `at`: transfers still running are cancelled, no further
+    // jobs are pulled, and every job already taken is reported with
+    // `cancelled` set
+    void setDeadline(HostScheduler::Clock::time_point at) { deadline = at; }
+
+    bool deadlinePassed() const { return expired; }
+    size_t cancelledCount() const { return cancelledChecks; }
+
+    const std::map<std::string, HostProtocolStats>& protocolStats() const { return protocols; }
+
+    // Interrupt the wait for network activity so the job source is asked
+    // again, e.g. after another thread queued work. Thread-safe.
+    void wakeup() { transport->wakeup(); }
+
+    // Run until `next` has no job and every started transfer has completed.
+    // `next` is asked again on every pass while work is in flight, so a
+    // source fed from another thread can keep adding jobs to a running engine.
+    void run(const std::function<bool(CheckJob&)>& next,
+             const std::function<void(const CheckOutcome&)>& onDone) {
+        if (!ready()) return;
+
+        bool exhausted = false;   // the source had nothing the last time it was asked
+        size_t inFlight = 0;
+
+        while (true) {
+            if (HostScheduler::Clock::now() >= deadline) {
+                expired = true;
+                abandon(onDone);
+                return;
+            }
+
+            // Keep a bounded backlog so the scheduler can interleave hosts
+            exhausted = false;
+            while (scheduler.pending() < maxPending) {
+                CheckJob job;
+                if (!next(job)) {
+                    exhausted = true;
+                    break;
+                }
+                if (health && !health->admit(job.host)) {
+                    onDone(skippedOutcome(job));
+                    continue;
+                }
+                scheduler.push(std::move(job));
+            }
+
+            // Start whatever the per-host buckets allow
+            auto now = HostScheduler::Clock::now();
+            HostScheduler::Clock::duration wait = std::chrono::seconds(1);
+            while (!idle.empty()) {
+                Transfer* t = idle.back();
+                if (!scheduler.pop(t->job, now, wait)) break;
+                if (health && health->blocked(t->job.host)) {
+                    scheduler.release();
+                    onDone(skippedOutcome(t->job));
+                    continue;
+                }
+                idle.pop_back();
+                start(t);
+                inFlight++;
+            }
+            if (hedge) {
+                inFlight += launchHedges(now, wait);
+            }
+            if (deadline != HostScheduler::Clock::time_point::max()) {
+                wait = std::min(wait, deadline - now);
+            }
+
+            if (inFlight == 0) {
+                if (exhausted && scheduler.pending() == 0) break;
+
+                // Everything left is rate limited; sleep until the next token
+                std::this_thread::sleep_for(wait);
+                continue;
+            }
+
+            results.clear();
+            int running = transport->perform(results);
+
+            for (const TransportResult& result : results) {
+                Transfer* t = &transfers[result.slot];
+                if (!t->running) continue;   // losing copy of a hedged pair, already dropped
+
+                CheckOutcome outcome{t->job, result.error, result.responseCode, false, result.seconds, false, false, result.timing, false};
+                if (outcome.error == CURLE_OPERATION_TIMEDOUT && t->shortTimeout && !t->twin) {
+                    // The history undersold this host: try once more with the full
+                    // --timeout rather than report a false negative
+                    CheckJob retry = t->job;
+                    retry.fullTimeout = true;
+                    finish(t);
+                    inFlight--;
+                    scheduler.push(std::move(retry));
+                    timeoutRetries++;
+                    continue;
+                }
+                if (outcome.error == CURLE_OK && !t->job.connectOnly) {
+                    outcome.found = profileFound(t->job.rule, outcome.responseCode, result.finalURL, t->scanner);
+                    recordProtocol(t, result);
+                    if (latency) latency->add(t->job.host, outcome.seconds);
+                }
+                if (health) {
+                    // A job whose URL host differs from its key has the username in the host name
+                    health->record(t->job.host, outcome.error, urlHost(t->job.url) != t->job.host);
+                }
+
+                finish(t);
+                inFlight--;
+
+                if (Transfer* other = t->twin) {
+                    t->twin = nullptr;
+                    other->twin = nullptr;
+                    // A failed copy leaves the answer to the one still running
+                    if (outcome.error != CURLE_OK) continue;
+
+                    finish(other, true);
+                    inFlight--;
+                    if (t->isHedge) hedgesWon++;
+                }
+
+                onDone(outcome);
+            }
+
+            if (inFlight > 0 && running > 0) {
+                int waitMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(wait).count();
+                transport->wait(waitMs);
+            }
+        }
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include "transport.hpp"
+#include "scheduler.hpp"
+
+// How a simulated host behaves, shared by FakeTransport and the benchmark's
+// mock HTTP server so both backends can be driven by the same scenario.
+struct FakeHostProfile {
+    double latencyMs = 50;     // median response time
+    double tailMs = 0;         // p99 response time; 0 means every response takes latencyMs
+    double errorRate = 0;      // fraction of requests that fail without a response
+    double foundRate = 0.5;    // fraction of URLs answered with foundStatus, the rest 404
+    long foundStatus = 200;
+    std::string body;          // served to GET requests, i.e. to body rules
+
+    // Log-normal response time with the configured median and p99
+    double sampleSeconds(std::mt19937& rng) const {
+        if (tailMs <= latencyMs) return latencyMs / 1000.0;
+        double sigma = std::log(tailMs / latencyMs) / 2.326;   // z-score of p99
+        std::lognormal_distribution<double> latency(std::log(latencyMs), sigma);
+        return latency(rng) / 1000.0;
+    }
+
+    bool sampleError(std::mt19937& rng) const {
+        return errorRate > 0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng) < errorRate;
+    }
+
+    // Status for `url`. Decided by a hash of the URL, so repeated and
+    // hedged requests for the same profile get the same answer.
+    long statusFor(const std::string& url) const {
+        size_t bucket = std::hash<std::string>()(url) % 10000;
+        return bucket < foundRate * 10000 ? foundStatus : 404;
+    }
+};
+
+// In-process transport that never touches the network: every request
+// completes after a latency drawn from its host's FakeHostProfile. Used by
+// the benchmark to measure the engine itself.
+class FakeTransport : public Transport {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        bool running = false;
+        Clock::time_point due;
+        TransportResult result;
+    };
+
+    std::vector<Request> requests;
+    FakeHostProfile fallback;
+    std::map<std::string, FakeHostProfile> profiles;
+    std::mt19937 rng;
+
+public:
+    FakeTransport(size_t slotCount, const FakeHostProfile& defaultProfile = FakeHostProfile(), unsigned seed = 1)
+        : requests(slotCount), fallback(defaultProfile), rng(seed) {}
+
+    // Behaviour for one host (as returned by urlHost()) instead of the default
+    void setProfile(const std::string& host, const FakeHostProfile& profile) { profiles[host] = profile; }
+
+    bool ready() const override { return !requests.empty(); }
+    size_t slots() const override { return requests.size(); }
+
+    void start(size_t slot, const CheckJob& job, long timeoutMs, BodyScanner* scanner) override {
+        auto found = profiles.find(urlHost(job.url));
+        const FakeHostProfile& profile = found == profiles.end() ? fallback : found->second;
+
+        Request& request = requests[slot];
+        request.running = true;
+        request.result = TransportResult{slot, CURLE_OK, 0, job.url, 0.0, TransferTiming(), CURL_HTTP_VERSION_1_1, 0, 0};
+
+        double seconds = profile.sampleSeconds(rng);
+        if (seconds * 1000.0 > timeoutMs) {
+            seconds = timeoutMs / 1000.0;
+            request.result.error = CURLE_OPERATION_TIMEDOUT;
+        } else if (profile.sampleError(rng)) {
+            request.result.error = CURLE_COULDNT_CONNECT;
+        } else if (!job.connectOnly) {
+            long status = profile.statusFor(job.url);
+            request.result.responseCode = status;
+            if (job.rule && job.rule->needsBody() && job.rule->statusMatches(status)) {
+                scanner->feed(profile.body.data(), profile.body.size());
+            }
+            request.result.timing.ttfb = seconds;
+            request.result.timing.bytes = (long long)profile.body.size();
+        }
+        request.result.seconds = seconds;
+        request.due = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    void cancel(size_t slot) override { requests[slot].running = false; }
+
+    int perform(std::vector<TransportResult>& done) override {
+        auto now = Clock::now();
+        int running = 0;
+        for (auto& request : requests) {
+            if (!request.running) continue;
+            if (request.due <= now) {
+                request.running = false;
+                done.push_back(request.result);
+            } else {
+                running++;
+            }
+        }
+        return running;
+    }
+
+    void wait(int waitMs) override {
+        auto until = Clock::now() + std::chrono::milliseconds(std::max(1, waitMs));
+        for (const auto& request : requests) {
+            if (request.running) until = std::min(until, request.due);
+        }
+        std::this_thread::sleep_until(until);
+    }
+};
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+// 64-bit FNV-1a, used for cache keys, platform revisions and record checksums
+inline uint64_t fnv1a64(const std::string& text, uint64_t hash = 1469598103934665603ULL) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
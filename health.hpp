@@ -0,0 +1,157 @@
+#pragma once
+#include <string>
+#include <map>
+#include <ctime>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "curl_compat.hpp"
+
+// Version of the health file format understood by this build
+#define HOST_HEALTH_VERSION 1
+
+// Per-host circuit breaker. A host that fails to resolve, connect or answer
+// within the timeout `threshold` times in a row is opened: its checks are
+// skipped without a request. After `cooldown` seconds one half-open probe is
+// let through; success closes the breaker, failure re-opens it for another
+// cooldown. Times are wall-clock so the state can be saved between runs.
+class HostHealth {
+public:
+    enum State { Closed, Open, HalfOpen };
+
+private:
+    struct Host {
+        int failures = 0;
+        long long openedAt = 0;   // unix time the breaker last opened, 0 if closed
+        bool probing = false;     // half-open probe in flight
+    };
+
+    int threshold;
+    long cooldown;
+    std::map<std::string, Host> hosts;
+    size_t skipped;
+
+    State state(const Host& host, long long now) const {
+        if (host.failures < threshold) return Closed;
+        return now - host.openedAt >= cooldown ? HalfOpen : Open;
+    }
+
+public:
+    HostHealth(int failureThreshold = 3, long cooldownSecs = 600)
+        : threshold(failureThreshold > 0 ? failureThreshold : 1), cooldown(cooldownSecs), skipped(0) {}
+
+    static bool isHostFailure(CURLcode error) {
+        return error == CURLE_COULDNT_RESOLVE_HOST || error == CURLE_COULDNT_CONNECT ||
+               error == CURLE_OPERATION_TIMEDOUT;
+    }
+
+    // Whether a new check for `host` may be queued. Returns false for an
+    // open breaker, and for a half-open one whose single probe is already out.
+    bool admit(const std::string& host) {
+        auto found = hosts.find(host);
+        if (found == hosts.end()) return true;
+
+        Host& entry = found->second;
+        switch (state(entry, time(nullptr))) {
+            case Closed:
+                return true;
+            case HalfOpen:
+                if (!entry.probing) {
+                    entry.probing = true;
+                    return true;
+                }
+                break;
+            case Open:
+                break;
+        }
+        skipped++;
+        return false;
+    }
+
+    // Whether an already queued check for `host` must be dropped because the
+    // breaker opened while it was waiting
+    bool blocked(const std::string& host) {
+        if (stateOf(host) != Open) return false;
+        skipped++;
+        return true;
+    }
+
+    // `perUserName` marks a URL with the username in the host name
+    // ("%s.ghost.io"). A failed lookup there usually means the user does not
+    // exist, so it neither counts as a failure nor proves the site is up;
+    // connect failures and timeouts still count against the site.
+    void record(const std::string& host, CURLcode error, bool perUserName = false) {
+        if (perUserName && error == CURLE_COULDNT_RESOLVE_HOST) {
+            auto found = hosts.find(host);
+            if (found != hosts.end()) found->second.probing = false;
+            return;
+        }
+        if (!isHostFailure(error)) {
+            // The host answered, even if the transfer failed later on
+            hosts.erase(host);
+            return;
+        }
+
+        Host& entry = hosts[host];
+        entry.probing = false;
+        if (++entry.failures >= threshold) entry.openedAt = (long long)time(nullptr);
+    }
+
+    State stateOf(const std::string& host) const {
+        auto found = hosts.find(host);
+        return found == hosts.end() ? Closed : state(found->second, time(nullptr));
+    }
+
+    size_t skippedCount() const { return skipped; }
+
+    // Hosts whose breaker is open or waiting for a probe
+    size_t unhealthyCount() const {
+        size_t count = 0;
+        long long now = time(nullptr);
+        for (const auto& entry : hosts) {
+            if (state(entry.second, now) != Closed) count++;
+        }
+        return count;
+    }
+
+    // Load state saved by a previous run. A missing file is not an error.
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) return true;
+
+        std::string line;
+        std::string magic;
+        int version = 0;
+        if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) ||
+            magic != "yougoldberg-health" || version != HOST_HEALTH_VERSION) {
+            error = path + " is not a version " + std::to_string(HOST_HEALTH_VERSION) + " health file";
+            return false;
+        }
+
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string host;
+            Host entry;
+            if (fields >> host >> entry.failures >> entry.openedAt && entry.failures > 0) {
+                hosts[host] = entry;
+            }
+        }
+        return true;
+    }
+
+    // Write the current state, replacing `path` atomically
+    bool save(const std::string& path) const {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            if (!file.is_open()) return false;
+
+            file << "yougoldberg-health\t" << HOST_HEALTH_VERSION << "\n";
+            for (const auto& entry : hosts) {
+                file << entry.first << "\t" << entry.second.failures << "\t" << entry.second.openedAt << "\n";
+            }
+            if (!file) return false;
+        }
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+};
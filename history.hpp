@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+#include <map>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "latency.hpp"
+
+// Version of the hit history file format understood by this build
+#define HISTORY_FILE_VERSION 1
+
+// How often each platform has turned up a profile, used to check the most
+// promising platforms first when a --deadline may cut the search short.
+class PlatformHistory {
+private:
+    struct Counts {
+        uint64_t checks = 0;
+        uint64_t found = 0;
+    };
+
+    std::map<std::string, Counts> platforms;
+
+public:
+    // Response time assumed for a host without latency history
+    static constexpr double DEFAULT_SECONDS = 1.0;
+
+    void record(const std::string& platform, bool found) {
+        Counts& counts = platforms[platform];
+        counts.checks++;
+        if (found) counts.found++;
+    }
+
+    // Hit rate with one pseudo-hit and one pseudo-miss, so platforms seen
+    // rarely (or never) start out at 50% instead of 0 or 100
+    double hitRate(const std::string& platform) const {
+        auto entry = platforms.find(platform);
+        if (entry == platforms.end()) return 0.5;
+        return (entry->second.found + 1.0) / (entry->second.checks + 2.0);
+    }
+
+    // Expected hits per second of waiting: the hit rate over the host's
+    // median response time
+    double score(const std::string& platform, const std::string& host, const LatencyTracker* latency) const {
+        double seconds = DEFAULT_SECONDS;
+        if (latency) {
+            auto found = latency->histograms().find(host);
+            if (found != latency->histograms().end() && found->second.count() > 0) {
+                seconds = std::max(0.01, found->second.percentile(0.50));
+            }
+        }
+        return hitRate(platform) / seconds;
+    }
+
+    size_t size() const { return platforms.size(); }
+
+    // Load counts saved by a previous run. A missing file is not an error.
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) return true;
+
+        std::string line;
+        std::string magic;
+        int version = 0;
+        if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) ||
+            magic != "yougoldberg-history" || version != HISTORY_FILE_VERSION) {
+            error = path + " is not a version " + std::to_string(HISTORY_FILE_VERSION) + " hit history file";
+            return false;
+        }
+
+        while (std::getline(file, line)) {
+            // Platform names may contain spaces, so split on tabs only
+            std::istringstream fields(line);
+            std::string name;
+            std::string checks;
+            std::string found;
+            if (!std::getline(fields, name, '\t') || !std::getline(fields, checks, '\t') || !std::getline(fields, found)) continue;
+
+            Counts counts;
+            counts.checks = std::strtoull(checks.c_str(), nullptr, 10);
+            counts.found = std::min(counts.checks, (uint64_t)std::strtoull(found.c_str(), nullptr, 10));
+            platforms[name] = counts;
+        }
+        return true;
+    }
+
+    // Write every platform's counts, replacing `path` atomically
+    bool save(const std::string& path) const {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            if (!file.is_open()) return false;
+
+            file << "yougoldberg-history\t" << HISTORY_FILE_VERSION << "\n";
+            for (const auto& entry : platforms) {
+                file << entry.first << "\t" << entry.second.checks << "\t" << entry.second.found << "\n";
+            }
+            if (!file) return false;
+        }
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+};
@@ -0,0 +1,525 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#endif
+#include "check_job.hpp"
+#include "platforms.hpp"
+#include "results.hpp"
+#include "cache.hpp"
+
+// Version of the run journal layout understood by this build
+#define RUN_JOURNAL_VERSION 1
+
+enum JournalKind : uint8_t {
+    JOURNAL_VERDICT = 1,   // the check got an answer; `status` is the HTTP status
+    JOURNAL_MISSING = 2,   // a checkpointed username's check that failed or was skipped
+};
+
+// One (username, platform) check. The journal file is a 16-byte header
+// followed by these records, appended as each check completes.
+struct JournalRecord {
+    uint64_t user;         // position of the username among the batch's valid usernames
+    uint32_t platform;     // index into the run's platform table
+    int32_t status;
+    uint8_t kind;
+    uint8_t found;
+    uint8_t reserved[2];
+    uint32_t checksum;     // guards against torn appends
+
+    uint32_t computeChecksum() const {
+        std::string bytes(reinterpret_cast<const char*>(this), offsetof(JournalRecord, checksum));
+        return (uint32_t)fnv1a64(bytes);
+    }
+};
+static_assert(sizeof(JournalRecord) == 24, "journal records must stay 24 bytes");
+
+struct JournalHeader {
+    char magic[4];         // "YGRJ"
+    uint32_t version;
+    uint64_t reserved;
+};
+static_assert(sizeof(JournalHeader) == 16, "journal header must stay 16 bytes");
+
+// Crash-safe progress of one --batch run, kept in a directory:
+//
+//   run.tsv          the batch and platform database the run belongs to
+//   checkpoint.ygr   results of the first N usernames, as a --results file
+//   journal.ygj      every check completed for usernames from N on
+//
+// Checks are appended to the journal as they complete. Once a minute the
+// usernames finished in input order are folded into the checkpoint and
+// the journal is rewritten with only what is left, so neither grows with
+// more than the run's results. A resumed run replays the checkpoint,
+// answers journaled checks without a request, and sends only the rest.
+//
+// Failed and skipped checks get no verdict. A username that has them is
+// still folded into the checkpoint, with them as its unchecked count, and
+// each one stays in the journal as a JOURNAL_MISSING record so a resumed
+// run can send it again (see resolve()).
+class RunJournal {
+private:
+    std::string root;
+    int fd;
+    std::unordered_map<std::string, uint32_t> ids;
+    ResultStore done;                                        // usernames [0, watermark)
+    uint64_t watermark;
+    uint64_t streamBase;                                     // batch position of the search's first username
+    std::map<uint64_t, std::vector<JournalRecord>> pending;  // checks of usernames past the watermark
+    std::map<uint64_t, std::string> finished;                // usernames past the watermark already reported
+    std::vector<JournalRecord> missing;                      // checks of usernames before the watermark to send again
+    size_t recalled;
+    size_t replayed;
+    std::chrono::steady_clock::time_point lastCheckpoint;
+
+    std::string runPath() const { return root + "/run.tsv"; }
+    std::string checkpointPath() const { return root + "/checkpoint.ygr"; }
+    std::string journalPath() const { return root + "/journal.ygj"; }
+
+    // Flush a file, or a directory's entries, to disk
+    static bool syncPath(const std::string& path) {
+#ifndef _WIN32
+        int sync = ::open(path.c_str(), O_RDONLY);
+        if (sync < 0) return false;
+        bool ok = fsync(sync) == 0;
+        ::close(sync);
+        return ok;
+#else
+        (void)path;
+        return true;
+#endif
+    }
+
+    // Fingerprint of the platform table, so a resumed run is known to use
+    // the same platform indices
+    static uint64_t fingerprint(const PlatformTable& platforms) {
+        uint64_t hash = fnv1a64("");
+        for (const auto& platform : platforms) hash = fnv1a64(platform.name + "\t" + platform.urlTemplate() + "\n", hash);
+        return hash;
+    }
+
+    static bool fileStamp(const std::string& path, long long& size, long long& mtime) {
+#ifndef _WIN32
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return false;
+        size = (long long)info.st_size;
+        mtime = (long long)info.st_mtime;
+        return true;
+#else
+        (void)path;
+        size = mtime = 0;
+        return true;
+#endif
+    }
+
+    void index(const PlatformTable& platforms) {
+        ids.clear();
+        for (size_t i = 0; i < platforms.size(); i++) ids[platforms[i].name] = (uint32_t)i;
+    }
+
+    bool openJournal(std::string& error) {
+#ifndef _WIN32
+        fd = ::open(journalPath().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            error = "could not open " + journalPath() + ": " + strerror(errno);
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size == 0) {
+            JournalHeader header = {{'Y', 'G', 'R', 'J'}, RUN_JOURNAL_VERSION, 0};
+            if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+                error = "could not initialize " + journalPath();
+                return false;
+            }
+        }
+        return true;
+#else
+        error = "run journals are not supported on this platform";
+        return false;
+#endif
+    }
+
+    // Checks of usernames past the checkpoint, from the journal file. A
+    // trailing partial record (interrupted append) is simply ignored.
+    bool readJournal(std::string& error) {
+        std::ifstream file(journalPath(), std::ios::binary);
+        if (!file.is_open()) return true;
+
+        JournalHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return true;
+        if (memcmp(header.magic, "YGRJ", 4) != 0 || header.version != RUN_JOURNAL_VERSION) {
+            error = journalPath() + " is not a version " + std::to_string(RUN_JOURNAL_VERSION) + " run journal";
+            return false;
+        }
+
+        JournalRecord record;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            if (record.checksum != record.computeChecksum() || record.platform >= ids.size()) continue;
+            if (record.kind == JOURNAL_VERDICT && record.user >= watermark) {
+                pending[record.user].push_back(record);
+            } else if (record.kind == JOURNAL_MISSING && record.user < watermark) {
+                missing.push_back(record);
+            }
+        }
+        return true;
+    }
+
+    bool append(const JournalRecord& record) {
+#ifndef _WIN32
+        return fd >= 0 && write(fd, &record, sizeof(record)) == (ssize_t)sizeof(record);
+#else
+        (void)record;
+        return false;
+#endif
+    }
+
+    // Fold the usernames finished in input order into the checkpoint. Their
+    // checks without a verdict are journaled as missing; checkpointNow()
+    // syncs them before the checkpoint that counts them.
+    void advance() {
+        std::vector<ResultStore::Hit> hits;
+        std::vector<bool> answered;
+        while (!finished.empty() && finished.begin()->first == watermark) {
+            hits.clear();
+            answered.assign(ids.size(), false);
+            for (const auto& record : pending[watermark]) {
+                answered[record.platform] = true;
+                if (record.found) hits.push_back({record.platform, (uint16_t)record.status});
+            }
+            size_t unanswered = 0;
+            for (uint32_t platform = 0; platform < answered.size(); platform++) {
+                if (answered[platform]) continue;
+                JournalRecord record;
+                memset(&record, 0, sizeof(record));
+                record.user = watermark;
+                record.platform = platform;
+                record.kind = JOURNAL_MISSING;
+                record.checksum = record.computeChecksum();
+                append(record);
+                missing.push_back(record);
+                unanswered++;
+            }
+            done.add(finished.begin()->second, hits, unanswered);
+            finished.erase(finished.begin());
+            pending.erase(watermark);
+            watermark++;
+        }
+    }
+
+public:
+    // Checkpoint interval
+    static constexpr double CHECKPOINT_SECONDS = 60.0;
+
+    RunJournal() : fd(-1), watermark(0), streamBase(0), recalled(0), replayed(0) {}
+
+    ~RunJournal() { close(); }
+
+    RunJournal(const RunJournal&) = delete;
+    RunJournal& operator=(const RunJournal&) = delete;
+
+    // Batch file and platform database (empty for the built-in one) of the
+    // run journaled in `directory`
+    static bool readRun(const std::string& directory, std::string& batchFile, std::string& platformsFile, std::string& error) {
+        std::string path = directory + "/run.tsv";
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = directory + " holds no journaled run";
+            return false;
+        }
+        std::string line;
+        std::string magic;
+        int version = 0;
+        if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) || magic != "yougoldberg-journal" ||
+            version != RUN_JOURNAL_VERSION) {
+            error = path + " is not a version " + std::to_string(RUN_JOURNAL_VERSION) + " run file";
+            return false;
+        }
+        while (std::getline(file, line)) {
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos) continue;
+            std::string key = line.substr(0, tab);
+            if (key == "batch") batchFile = line.substr(tab + 1);
+            else if (key == "platforms") platformsFile = line.substr(tab + 1);
+        }
+        return true;
+    }
+
+    // Start journaling a new run of `batchFile` against `platforms`
+    bool create(const std::string& directory, const std::string& batchFile, const std::string& platformsFile,
+                const PlatformTable& platforms, std::string& error) {
+#ifndef _WIN32
+        root = directory;
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            error = "could not create " + directory + ": " + strerror(errno);
+            return false;
+        }
+        struct stat info;
+        if (stat(runPath().c_str(), &info) == 0) {
+            error = directory + " already holds a journaled run; continue it with --resume " + directory;
+            return false;
+        }
+
+        // Absolute paths, so the run can be resumed from anywhere
+        char resolved[PATH_MAX];
+        std::string batch = realpath(batchFile.c_str(), resolved) ? resolved : batchFile;
+        std::string database = platformsFile.empty() || !realpath(platformsFile.c_str(), resolved) ? platformsFile : resolved;
+        long long size = 0, mtime = 0;
+        fileStamp(batch, size, mtime);
+
+        std::ofstream file(runPath() + ".tmp", std::ios::trunc);
+        file << "yougoldberg-journal\t" << RUN_JOURNAL_VERSION << "\n"
+             << "batch\t" << batch << "\n"
+             << "size\t" << size << "\n"
+             << "mtime\t" << mtime << "\n"
+             << "platforms\t" << database << "\n"
+             << "fingerprint\t" << fingerprint(platforms) << "\n";
+        file.close();
+        if (!file || std::rename((runPath() + ".tmp").c_str(), runPath().c_str()) != 0) {
+            error = "could not write " + runPath();
+            return false;
+        }
+
+        index(platforms);
+        done = ResultStore(platforms);
+        std::remove(journalPath().c_str());
+        std::remove(checkpointPath().c_str());
+        lastCheckpoint = std::chrono::steady_clock::now();
+        return openJournal(error);
+#else
+        (void)directory;
+        (void)batchFile;
+        (void)platformsFile;
+        (void)platforms;
+        error = "run journals are not supported on this platform";
+        return false;
+#endif
+    }
+
+    // Continue the run journaled in `directory`; `platforms` must be the
+    // table loaded from what readRun() returned
+    bool resume(const std::string& directory, const PlatformTable& platforms, std::string& error) {
+        root = directory;
+        std::ifstream file(runPath());
+        std::string line;
+        std::string batch;
+        long long size = -1, mtime = -1;
+        uint64_t expected = 0;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string key;
+            std::getline(fields, key, '\t');
+            if (key == "batch") std::getline(fields, batch);
+            else if (key == "size") fields >> size;
+            else if (key == "mtime") fields >> mtime;
+            else if (key == "fingerprint") fields >> expected;
+        }
+
+        long long nowSize = 0, nowMtime = 0;
+        if (!fileStamp(batch, nowSize, nowMtime)) {
+            error = "could not open batch file " + batch;
+            return false;
+        }
+        if (nowSize != size || nowMtime != mtime) {
+            error = batch + " has changed since the run started, so the journal no longer matches it";
+            return false;
+        }
+        if (fingerprint(platforms) != expected) {
+            error = "the platform database has changed since the run started, so the journal no longer matches it";
+            return false;
+        }
+
+        index(platforms);
+        done = ResultStore(platforms);
+        std::ifstream checkpoint(checkpointPath());
+        if (checkpoint.is_open()) {
+            checkpoint.close();
+            if (!done.load(checkpointPath(), error)) return false;
+        }
+        watermark = done.size();
+        streamBase = watermark;
+        if (!readJournal(error)) return false;
+        for (const auto& entry : pending) replayed += entry.second.size();
+        lastCheckpoint = std::chrono::steady_clock::now();
+        return openJournal(error);
+    }
+
+    // Results of the usernames covered by the checkpoint, in batch order.
+    // The search continues with the username after them.
+    const ResultStore& checkpoint() const { return done; }
+
+    // Checks loaded from the journal when resuming
+    size_t journaledChecks() const { return replayed; }
+
+    // Checks of checkpointed usernames that failed or were skipped. A
+    // resumed run sends them again before the search continues: the `i`th
+    // is `missingCheck(i)`, its answer goes to resolve(), and applyResolved()
+    // folds the answers into the checkpoint.
+    size_t missingCount() const { return missing.size(); }
+    const JournalRecord& missingCheck(size_t i) const { return missing[i]; }
+
+    // Answer to the `i`th missing check; false if it failed or was skipped again
+    bool resolve(size_t i, const CheckOutcome& outcome) {
+        if (i >= missing.size() || outcome.skipped || outcome.cancelled || outcome.error != CURLE_OK) return false;
+        JournalRecord& record = missing[i];
+        record.kind = JOURNAL_VERDICT;
+        record.status = (int32_t)outcome.responseCode;
+        record.found = outcome.found ? 1 : 0;
+        return true;
+    }
+
+    // Rebuild the checkpoint with the resolved checks and save it; only the
+    // unresolved ones stay missing
+    bool applyResolved() {
+        std::map<uint64_t, std::vector<ResultStore::Hit>> added;
+        std::map<uint64_t, size_t> unanswered;
+        std::vector<JournalRecord> still;
+        for (const auto& record : missing) {
+            size_t& count = unanswered[record.user];
+            if (record.kind == JOURNAL_MISSING) {
+                count++;
+                still.push_back(record);
+            } else if (record.found) {
+                added[record.user].push_back({record.platform, (uint16_t)record.status});
+            }
+        }
+        if (still.size() == missing.size()) return true;
+
+        ResultStore rebuilt = done.emptyCopy();
+        std::vector<ResultStore::Hit> hits;
+        for (size_t user = 0; user < done.size(); user++) {
+            done.hits(user, hits);
+            size_t uncheckedCount = done.uncheckedCount(user);
+            auto retried = unanswered.find(user);
+            if (retried != unanswered.end()) {
+                auto found = added.find(user);
+                if (found != added.end()) hits.insert(hits.end(), found->second.begin(), found->second.end());
+                uncheckedCount = retried->second;
+            }
+            rebuilt.add(done.username(user), hits, uncheckedCount);
+        }
+        done = std::move(rebuilt);
+        missing = std::move(still);
+        return checkpointNow();
+    }
+
+    // Checks answered from the journal so far
+    size_t recalledChecks() const { return recalled; }
+
+    // Outcome of `job` for the `id`th username of the search (from 1), if
+    // it was journaled before the run was interrupted
+    bool recall(size_t id, const CheckJob& job, CheckOutcome& outcome) {
+        auto platform = ids.find(job.platform);
+        auto user = pending.find(streamBase + id - 1);
+        if (platform == ids.end() || user == pending.end()) return false;
+        for (const auto& record : user->second) {
+            if (record.platform != platform->second) continue;
+            outcome = CheckOutcome{job, CURLE_OK, record.status, record.found != 0, 0.0, true, false, {}, false};
+            recalled++;
+            return true;
+        }
+        return false;
+    }
+
+    // Journal a completed check of the `id`th username. Only answered
+    // checks are kept: false for one that failed or was skipped by the
+    // circuit breaker, which finish() then leaves missing.
+    bool record(size_t id, const CheckOutcome& outcome) {
+        if (outcome.skipped || outcome.cancelled || outcome.error != CURLE_OK) return false;
+        auto platform = ids.find(outcome.job.platform);
+        if (platform == ids.end()) return false;
+
+        uint64_t user = streamBase + id - 1;
+        auto known = pending.find(user);
+        if (known != pending.end()) {
+            for (const auto& record : known->second) {
+                if (record.platform == platform->second) return true;
+            }
+        }
+
+        JournalRecord record;
+        memset(&record, 0, sizeof(record));
+        record.user = user;
+        record.platform = platform->second;
+        record.kind = JOURNAL_VERDICT;
+        record.status = (int32_t)outcome.responseCode;
+        record.found = outcome.found ? 1 : 0;
+        record.checksum = record.computeChecksum();
+        if (append(record)) pending[user].push_back(record);
+        return true;
+    }
+
+    // Every check of the `id`th username, `username`, has completed
+    void finish(size_t id, const std::string& username) {
+        finished[streamBase + id - 1] = username;
+        advance();
+        if (std::chrono::duration<double>(std::chrono::steady_clock::now() - lastCheckpoint).count() >= CHECKPOINT_SECONDS) {
+            checkpointNow();
+        }
+    }
+
+    // Save the checkpoint, then rewrite the journal with the checks of
+    // usernames past it. Either file alone is consistent with the other,
+    // so a crash in between loses nothing, as long as the checkpoint is on
+    // disk before the journal loses the checks it now holds.
+    bool checkpointNow() {
+#ifndef _WIN32
+        lastCheckpoint = std::chrono::steady_clock::now();
+        // Missing checks appended by advance() must be on disk before a checkpoint counts them
+        if (fd < 0 || fsync(fd) != 0 || !done.save(checkpointPath(), true) || !syncPath(root)) return false;
+
+        std::string temp = journalPath() + ".tmp";
+        int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out < 0) return false;
+        JournalHeader header = {{'Y', 'G', 'R', 'J'}, RUN_JOURNAL_VERSION, 0};
+        bool ok = write(out, &header, sizeof(header)) == (ssize_t)sizeof(header);
+        size_t missingBytes = missing.size() * sizeof(JournalRecord);
+        ok = ok && (missing.empty() || write(out, missing.data(), missingBytes) == (ssize_t)missingBytes);
+        for (const auto& entry : pending) {
+            size_t bytes = entry.second.size() * sizeof(JournalRecord);
+            ok = ok && write(out, entry.second.data(), bytes) == (ssize_t)bytes;
+        }
+        ok = ok && fsync(out) == 0;
+        ::close(out);
+        if (!ok || std::rename(temp.c_str(), journalPath().c_str()) != 0) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        syncPath(root);
+
+        ::close(fd);
+        fd = ::open(journalPath().c_str(), O_WRONLY | O_APPEND);
+        return fd >= 0;
+#else
+        return false;
+#endif
+    }
+
+    // Final checkpoint; after a complete run it holds every username
+    bool close() {
+        if (fd < 0) return true;
+        bool ok = checkpointNow();
+#ifndef _WIN32
+        if (fd >= 0) ::close(fd);
+#endif
+        fd = -1;
+        return ok;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+    const std::string& path() const { return root; }
+};
@@ -0,0 +1,171 @@
+#pragma once
+#include <string>
+#include <map>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+// Version of the latency file format understood by this build
+#define LATENCY_FILE_VERSION 1
+
+// Log-scale latency histogram: bucket i holds samples up to
+// 1 ms * 2^(i/4), i.e. about 19% resolution from 1 ms to roughly a minute.
+class LatencyHistogram {
+public:
+    static constexpr int BUCKETS = 64;
+
+private:
+    uint32_t counts[BUCKETS];
+    uint64_t total;
+
+public:
+    // Once a histogram holds this many samples all buckets are halved, so
+    // persisted history fades and recent behaviour dominates
+    static constexpr uint64_t DECAY_AT = 4096;
+
+    LatencyHistogram() : total(0) { std::fill(counts, counts + BUCKETS, 0u); }
+
+    static double bucketLimit(int bucket) { return 0.001 * std::pow(2.0, bucket / 4.0); }
+
+    static int bucketFor(double seconds) {
+        if (seconds <= 0.001) return 0;
+        int bucket = (int)std::ceil(4.0 * std::log2(seconds / 0.001));
+        return std::min(bucket, BUCKETS - 1);
+    }
+
+    void add(double seconds) {
+        if (total >= DECAY_AT) {
+            total = 0;
+            for (auto& count : counts) {
+                count /= 2;
+                total += count;
+            }
+        }
+        counts[bucketFor(seconds)]++;
+        total++;
+    }
+
+    uint64_t count() const { return total; }
+
+    // Upper bound of the bucket holding quantile `q` (0..1), in seconds
+    double percentile(double q) const {
+        if (total == 0) return 0.0;
+        uint64_t rank = (uint64_t)std::ceil(q * total);
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank && counts[i] > 0) return bucketLimit(i);
+        }
+        return bucketLimit(BUCKETS - 1);
+    }
+
+    // "bucket:count" pairs for non-empty buckets
+    std::string serialize() const {
+        std::string out;
+        for (int i = 0; i < BUCKETS; i++) {
+            if (counts[i] == 0) continue;
+            if (!out.empty()) out += ',';
+            out += std::to_string(i) + ':' + std::to_string(counts[i]);
+        }
+        return out;
+    }
+
+    bool parse(const std::string& text) {
+        std::istringstream pairs(text);
+        std::string pair;
+        while (std::getline(pairs, pair, ',')) {
+            int bucket = -1;
+            unsigned long count = 0;
+            if (sscanf(pair.c_str(), "%d:%lu", &bucket, &count) != 2 || bucket < 0 || bucket >= BUCKETS) return false;
+            counts[bucket] += (uint32_t)count;
+            total += count;
+        }
+        return true;
+    }
+};
+
+// Per-host latency history, used to size each host's timeout and to decide
+// when a slow request deserves a hedged duplicate.
+class LatencyTracker {
+private:
+    std::map<std::string, LatencyHistogram> hosts;
+    double factor;
+    uint64_t minSamples;
+
+public:
+    // Adaptive timeouts never go below this, whatever the history says
+    static constexpr long MIN_TIMEOUT_MS = 1000;
+
+    LatencyTracker(double timeoutFactor = 3.0, uint64_t samplesNeeded = 20)
+        : factor(timeoutFactor), minSamples(samplesNeeded) {}
+
+    void add(const std::string& host, double seconds) { hosts[host].add(seconds); }
+
+    // p99 x factor, clamped to [MIN_TIMEOUT_MS, capMs]; the cap itself
+    // until the host has enough samples or when adaptive timeouts are off
+    long timeoutMs(const std::string& host, long capMs) const {
+        if (factor <= 0) return capMs;
+        auto found = hosts.find(host);
+        if (found == hosts.end() || found->second.count() < minSamples) return capMs;
+
+        long adaptive = (long)std::ceil(found->second.percentile(0.99) * factor * 1000.0);
+        return std::min(capMs, std::max(MIN_TIMEOUT_MS, adaptive));
+    }
+
+    // Seconds after which a request to `host` is slower than 95% of its
+    // history; false until the host has enough samples
+    bool hedgeDelay(const std::string& host, double& seconds) const {
+        auto found = hosts.find(host);
+        if (found == hosts.end() || found->second.count() < minSamples) return false;
+        seconds = found->second.percentile(0.95);
+        return true;
+    }
+
+    const std::map<std::string, LatencyHistogram>& histograms() const { return hosts; }
+
+    // Load histograms saved by a previous run. A missing file is not an error.
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) return true;
+
+        std::string line;
+        std::string magic;
+        int version = 0;
+        if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) ||
+            magic != "yougoldberg-latency" || version != LATENCY_FILE_VERSION) {
+            error = path + " is not a version " + std::to_string(LATENCY_FILE_VERSION) + " latency file";
+            return false;
+        }
+
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string host;
+            std::string buckets;
+            if (!(fields >> host >> buckets)) continue;
+
+            LatencyHistogram histogram;
+            if (histogram.parse(buckets)) hosts[host] = histogram;
+        }
+        return true;
+    }
+
+    // Write every histogram, replacing `path` atomically
+    bool save(const std::string& path) const {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            if (!file.is_open()) return false;
+
+            file << "yougoldberg-latency\t" << LATENCY_FILE_VERSION << "\n";
+            for (const auto& entry : hosts) {
+                if (entry.second.count() == 0) continue;
+                file << entry.first << "\t" << entry.second.serialize() << "\n";
+            }
+            if (!file) return false;
+        }
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+};
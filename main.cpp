@@ -3,40 +3,31 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
-#ifdef NO_CURL
-// Stub curl functions for compilation without libcurl
-typedef void CURL;
-typedef int CURLcode;
-#define CURLE_OK 0
-#define CURL_GLOBAL_DEFAULT 0
-#define CURLOPT_URL 10000
-#define CURLOPT_NOBODY 44
-#define CURLOPT_TIMEOUT 13
-#define CURLOPT_USERAGENT 10018
-#define CURLOPT_FOLLOWLOCATION 52
-#define CURLOPT_SSL_VERIFYPEER 64
-#define CURLOPT_SSL_VERIFYHOST 81
-#define CURLOPT_WRITEFUNCTION 20011
-#define CURLOPT_WRITEDATA 10001
-#define CURLINFO_RESPONSE_CODE 2097154
-
-CURL *curl_easy_init(void) { return (CURL*)1; }
-CURLcode curl_easy_setopt(CURL *curl, int option, ...) { return CURLE_OK; }
-CURLcode curl_easy_perform(CURL *curl) { return CURLE_OK; }
-CURLcode curl_easy_getinfo(CURL *curl, int info, ...) { return CURLE_OK; }
-void curl_easy_cleanup(CURL *curl) {}
-const char *curl_easy_strerror(CURLcode errornum) { return "OK"; }
-int curl_global_init(long flags) { return CURLE_OK; }
-void curl_global_cleanup(void) {}
-#else
-#include <curl/curl.h>
-#endif
 #include <cstdio>
+#include <cstdint>
 #include <memory>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <csignal>
 #include <thread>
+#include <mutex>
+#include <iterator>
+#include <condition_variable>
+#include "engine.hpp"
 #include "platforms.hpp"
+#include "batch.hpp"
+#include "sink.hpp"
+#include "cache.hpp"
+#include "metrics.hpp"
+#include "history.hpp"
+#include "server.hpp"
+#include "results.hpp"
+#include "shard.hpp"
+#include "variants.hpp"
+#include "journal.hpp"
 
 // ANSI color codes for better output formatting
 #define RESET_COLOR   "\033[0m"
@@ -53,106 +44,508 @@ struct FoundProfile {
     long responseCode;
 };
 
-// Callback function to handle response data (we don't need the content)
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    size_t totalSize = size * nmemb;
-    userp->append((char*)contents, totalSize);
-    return totalSize;
-}
+// Per-username bookkeeping while its checks are in flight
+struct UserSearch {
+    std::string username;
+    size_t remaining;
+    std::vector<FoundProfile> found;
+    size_t unchecked;    // checks cut off by the deadline; non-zero means incomplete
+    size_t id;           // position of the username in the search's input, from 1
+};
+
+// How far --variants cut down the checks of one identity
+struct VariantStats {
+    size_t candidates;   // variants x platforms
+    size_t invalid;      // names a platform cannot have
+    size_t duplicates;   // names a platform resolves to an URL already planned
+    size_t checks;       // distinct URLs actually checked
+};
 
 class OSINTChecker {
 private:
-    CURL* curl;
     bool verbose;
-    int timeout;
+    PlatformTable platforms;
+    std::unique_ptr<ConnectionShare> share;
+    std::unique_ptr<CheckEngine> engine;
+    NDJSONSink* sink;
+    ResultCache* cache;
+    long cacheMaxAge;
+    bool cacheRefresh;
+    RunMetrics* metrics;
+    PlatformHistory* history;
+    LatencyTracker* latency;
+    RunJournal* journal;
+    double deadlineSeconds;
+    std::vector<size_t> order;   // platform indices in the order they are checked
     
-public:
-    OSINTChecker(bool verboseMode = false, int timeoutSecs = 10) 
-        : curl(nullptr), verbose(verboseMode), timeout(timeoutSecs) {
-        curl_global_init(CURL_GLOBAL_DEFAULT);
-        curl = curl_easy_init();
+    // Most promising platforms first: highest historical hit rate per
+    // second of expected response time. Ties keep alphabetical order.
+    void orderPlatforms() {
+        order.resize(platforms.size());
+        std::vector<double> scores(platforms.size());
+        for (size_t i = 0; i < platforms.size(); i++) {
+            order[i] = i;
+            scores[i] = history ? history->score(platforms[i].name, platforms[i].host, latency) : 0.0;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+    }
+    
+    // Name verdicts for `username` on `platform` are cached under: the one
+    // the site resolves it to, so every spelling the site treats alike (and
+    // plain searches and --variants) share one entry
+    static std::string cacheName(const Platform& platform, const std::string& username) {
+        std::string name;
+        return platform.normalize(username, name) ? name : username;
+    }
+    
+    // Bookkeeping every completed check gets, whatever kind of search it
+    // belongs to: cache, hit history, -v line, metrics and NDJSON record
+    void record(const CheckOutcome& outcome, const std::string& username) {
+        bool fresh = !outcome.cached && !outcome.skipped && !outcome.cancelled && outcome.error == CURLE_OK;
+        
+        const Platform* platform = cache && fresh ? platforms.find(outcome.job.platform) : nullptr;
+        if (platform) {
+            cache->store(platform->name, outcome.job.revision, cacheName(*platform, username), outcome.responseCode,
+                         outcome.found);
+        }
+        if (history && fresh) {
+            history->record(outcome.job.platform, outcome.found);
+        }
+        
+        if (verbose) {
+            if (outcome.cancelled) {
+                std::cout << "\n" << YELLOW_COLOR << "  ⏱️  " << outcome.job.platform << " -> cancelled: deadline reached"
+                          << RESET_COLOR;
+            } else if (outcome.skipped) {
+                std::cout << "\n" << YELLOW_COLOR << "  ⚡ " << outcome.job.platform << " -> skipped: host unhealthy ("
+                          << outcome.job.host << ")" << RESET_COLOR;
+            } else if (outcome.error != CURLE_OK) {
+                std::cout << "\n" << RED_COLOR << "  ✗ CURL Error (" << outcome.job.platform << "): "
+                          << curl_easy_strerror(outcome.error) << RESET_COLOR;
+            } else {
+                std::cout << "\n  " << outcome.job.platform << " -> " << outcome.responseCode << " (" << outcome.job.url << ")"
+                          << (outcome.cached ? " [cached]" : "");
+            }
+        }
         
-        if (curl) {
-            // Set common curl options
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
-            curl_easy_setopt(curl, CURLOPT_USERAGENT, "Mozilla/5.0 (compatible; OSINT-CLI/1.0)");
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
-            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L); // HEAD request only
+        if (metrics) metrics->record(outcome);
+        if (sink) sink->write(formatCheckRecord(username, outcome));
+    }
+    
+    // Fresh cached verdicts complete without touching the network
+    bool cachedOutcome(const Platform& platform, const std::string& username, const CheckJob& job, CheckOutcome& outcome) {
+        CacheRecord record;
+        long maxAge = platform.ttl >= 0 ? platform.ttl : cacheMaxAge;
+        if (!cache || cacheRefresh || !cache->lookup(platform.name, platform.revision, cacheName(platform, username), maxAge, record)) {
+            return false;
         }
+        outcome = CheckOutcome{job, CURLE_OK, record.status, record.found != 0, 0.0, true, false, {}, false};
+        return true;
     }
     
-    ~OSINTChecker() {
-        if (curl) {
-            curl_easy_cleanup(curl);
+    void armDeadline() {
+        if (deadlineSeconds > 0) {
+            engine->setDeadline(HostScheduler::Clock::now() + std::chrono::duration_cast<HostScheduler::Clock::duration>(
+                                                                   std::chrono::duration<double>(deadlineSeconds)));
         }
+    }
+    
+public:
+    OSINTChecker(bool verboseMode = false, const EngineOptions& options = EngineOptions(),
+                 const PlatformTable& platformTable = PlatformTable::builtin()) 
+        : verbose(verboseMode), platforms(platformTable), sink(nullptr),
+          cache(nullptr), cacheMaxAge(0), cacheRefresh(false), metrics(nullptr),
+          history(nullptr), latency(nullptr), journal(nullptr), deadlineSeconds(0) {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        share.reset(new ConnectionShare());
+        engine.reset(new CheckEngine(options, share.get()));
+    }
+    
+    ~OSINTChecker() {
+        // Easy handles must go before the share they are attached to
+        engine.reset();
+        share.reset();
         curl_global_cleanup();
     }
     
-    bool checkURL(const std::string& url, long& responseCode) {
-        if (!curl) return false;
+    size_t platformCount() const { return platforms.size(); }
+    
+    // Stream one record per completed check (found or not) to `output`
+    void setSink(NDJSONSink* output) { sink = output; }
+    
+    // Answer checks from `resultCache` when an entry is younger than the
+    // platform's ttl (or `maxAge`); `refresh` skips reads but still records.
+    void setCache(ResultCache* resultCache, long maxAge, bool refresh) {
+        cache = resultCache;
+        cacheMaxAge = maxAge;
+        cacheRefresh = refresh;
+    }
+    
+    // Resolve and connect (including the TLS handshake) to every fixed
+    // platform host up front, so DNS answers and TLS session IDs are already
+    // cached in the share when the real checks start. Hosts that depend on
+    // the username (e.g. "%s.bandcamp.com") cannot be prefetched.
+    void prefetch() {
+        std::vector<std::string> hosts;
+        for (const auto& platform : platforms) {
+            // The host is only known up front when the username comes after it
+            size_t hostStart = platform.prefix.find("://");
+            if (hostStart == std::string::npos) continue;
+            size_t hostEnd = platform.prefix.find('/', hostStart + 3);
+            if (hostEnd == std::string::npos) continue;
+            
+            std::string origin = platform.prefix.substr(0, hostEnd + 1);
+            if (std::find(hosts.begin(), hosts.end(), origin) == hosts.end()) {
+                hosts.push_back(origin);
+            }
+        }
+        
+        size_t index = 0;
+        engine->run([&](CheckJob& job) {
+            if (index == hosts.size()) return false;
+            job.platform = "prefetch";
+            job.url = hosts[index++];
+            job.host = hostKey(job.url);
+            job.connectOnly = true;
+            return true;
+        }, [](const CheckOutcome&) {});
+    }
+    
+    // Aggregate phase timings of every request into `runMetrics`
+    void setMetrics(RunMetrics* runMetrics) { metrics = runMetrics; }
+    
+    // Skip hosts whose circuit breaker is open; `health` also learns from every check
+    void setHealth(HostHealth* health) { engine->setHealth(health); }
+    
+    // Derive per-host timeouts and hedge delays from `latency`, which also
+    // records every successful check
+    void setLatency(LatencyTracker* tracker) {
+        latency = tracker;
+        engine->setLatency(tracker);
+    }
+    
+    // Order platforms by the hit rates in `platformHistory`, which also
+    // learns from every fresh check
+    void setHistory(PlatformHistory* platformHistory) { history = platformHistory; }
+    
+    // Journal every check of searchStream() to `runJournal`, and answer
+    // the checks it already holds without a request
+    void setJournal(RunJournal* runJournal) { journal = runJournal; }
+    
+    // Give up on whatever is unanswered `seconds` after a search starts;
+    // 0 means no deadline
+    void setDeadline(double seconds) { deadlineSeconds = seconds; }
+    
+    bool deadlinePassed() const { return engine->deadlinePassed(); }
+    
+    // Make a running search ask `nextUser` for more work now. Thread-safe.
+    void wakeup() { engine->wakeup(); }
+    
+    size_t hedgeCount() const { return engine->hedgeCount(); }
+    size_t hedgeWins() const { return engine->hedgeWins(); }
+    size_t retryCount() const { return engine->retryCount(); }
+    
+    ShareStats connectionStats() const { return share->snapshot(); }
+    
+    const std::map<std::string, HostProtocolStats>& protocolStats() const { return engine->protocolStats(); }
+    
+    // Check every username produced by `nextUser` against all platforms.
+    // Work items are expanded lazily, so only the usernames that currently
+    // have checks queued or in flight are held in memory. `onUser` fires as
+    // soon as all checks for one username have completed. `nextUser` may
+    // return false while checks are running and be asked again later; the
+    // search ends once it has nothing left and everything has completed.
+    bool searchStream(const std::function<bool(std::string&)>& nextUser,
+                      const std::function<void(UserSearch&)>& onUser,
+                      const std::function<void(const CheckOutcome&)>& onCheck = nullptr) {
+        if (!engine->ready()) {
+            std::cerr << RED_COLOR << "Error: Could not initialize curl" << RESET_COLOR << std::endl;
+            return false;
+        }
+        if (platforms.empty()) return true;
+        
+        std::unordered_map<size_t, UserSearch> active;
+        size_t nextId = 0;
+        size_t index = platforms.size();
+        const std::string* username = nullptr;
+        
+        // Completion order depends on the network; report in platform order
+        auto finishUser = [&](size_t id) {
+            UserSearch& search = active[id];
+            std::sort(search.found.begin(), search.found.end(),
+                      [](const FoundProfile& a, const FoundProfile& b) { return a.platform < b.platform; });
+            if (journal) journal->finish(id, search.username);
+            onUser(search);
+            active.erase(id);
+        };
+        
+        auto complete = [&](const CheckOutcome& outcome) {
+            UserSearch& search = active[outcome.job.user];
+            record(outcome, search.username);
+            if (journal) journal->record(outcome.job.user, outcome);
+            
+            if (outcome.cancelled) {
+                search.unchecked++;
+            } else if (!outcome.skipped && outcome.error == CURLE_OK && outcome.found) {
+                // Found when the platform's detection rule accepts the response
+                search.found.push_back({outcome.job.platform, outcome.job.url, outcome.responseCode});
+            }
+            if (onCheck) onCheck(outcome);
+            
+            if (--search.remaining == 0) {
+                finishUser(outcome.job.user);
+            }
+        };
+        
+        auto next = [&](CheckJob& job) {
+            while (true) {
+                if (index == platforms.size()) {
+                    std::string name;
+                    if (!nextUser(name)) return false;
+                    UserSearch& search = active[++nextId];
+                    search = {name, platforms.size(), {}, 0, nextId};
+                    username = &search.username;
+                    index = 0;
+                }
+                
+                const Platform& platform = platforms[order[index++]];
+                platform.buildURL(*username, job.url);
+                job.platform = platform.name;
+                job.host = platform.host;
+                job.rule = &platform.rule;
+                job.revision = platform.revision;
+                job.user = nextId;
+                
+                // Checks journaled before an interruption are not sent again
+                CheckOutcome cached;
+                if ((journal && journal->recall(nextId, job, cached)) || cachedOutcome(platform, *username, job, cached)) {
+                    complete(cached);
+                    continue;
+                }
+                return true;
+            }
+        };
+        
+        orderPlatforms();
+        armDeadline();
+        engine->run(next, complete);
         
-        std::string responseBuffer;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseBuffer);
+        // Usernames the deadline cut short are reported with what they have
+        std::vector<size_t> unfinished;
+        for (const auto& entry : active) unfinished.push_back(entry.first);
+        std::sort(unfinished.begin(), unfinished.end());
+        for (size_t id : unfinished) {
+            UserSearch& search = active[id];
+            search.unchecked += search.remaining;
+            search.remaining = 0;
+            finishUser(id);
+        }
+        return true;
+    }
+    
+    // Send again the checks a resumed journal's checkpoint is missing (they
+    // failed or were skipped before), and fold the answers into it. Returns
+    // how many were answered this time.
+    size_t retryJournaled() {
+        if (!journal || journal->missingCount() == 0) return 0;
+        if (!engine->ready()) {
+            std::cerr << RED_COLOR << "Error: Could not initialize curl" << RESET_COLOR << std::endl;
+            return 0;
+        }
         
-        CURLcode res = curl_easy_perform(curl);
+        const ResultStore& checkpoint = journal->checkpoint();
+        size_t answered = 0;
+        auto complete = [&](const CheckOutcome& outcome) {
+            record(outcome, checkpoint.username(journal->missingCheck(outcome.job.user).user));
+            if (journal->resolve(outcome.job.user, outcome)) answered++;
+        };
         
-        if (res != CURLE_OK) {
-            if (verbose) {
-                std::cout << RED_COLOR << "  ✗ CURL Error: " << curl_easy_strerror(res) << RESET_COLOR << std::endl;
+        size_t next = 0;
+        std::string username;
+        engine->run([&](CheckJob& job) {
+            while (next < journal->missingCount()) {
+                const JournalRecord& check = journal->missingCheck(next);
+                const Platform& platform = platforms[check.platform];
+                username = checkpoint.username(check.user);
+                platform.buildURL(username, job.url);
+                job.platform = platform.name;
+                job.host = platform.host;
+                job.rule = &platform.rule;
+                job.revision = platform.revision;
+                job.user = next++;
+                
+                CheckOutcome cached;
+                if (cachedOutcome(platform, username, job, cached)) {
+                    complete(cached);
+                    continue;
+                }
+                return true;
             }
             return false;
+        }, complete);
+        
+        if (!journal->applyResolved()) {
+            std::cerr << RED_COLOR << "Error: Could not write the checkpoint in " << journal->path() << RESET_COLOR << std::endl;
+        }
+        return answered;
+    }
+    
+    // Check every spelling in `variants` (of one identity) on every
+    // platform. Each variant is first normalized the way the platform would
+    // (case folding, dropped characters); variants the platform cannot have
+    // are not sent, and variants that end up at the same URL share one
+    // request whose verdict is attributed to each of them. Results are in
+    // the order of `variants`. `requested` gets the same checks grouped by
+    // the name each platform was actually asked for, so their URLs can be
+    // rebuilt from name and template (as a --results file does).
+    std::vector<UserSearch> searchVariants(const std::vector<std::string>& variants, VariantStats& stats,
+                                           std::vector<UserSearch>& requested) {
+        std::vector<UserSearch> results;
+        for (size_t i = 0; i < variants.size(); i++) {
+            results.push_back({variants[i], 0, {}, 0, i + 1});
+        }
+        requested.clear();
+        stats = {variants.size() * platforms.size(), 0, 0, 0};
+        if (!engine->ready()) {
+            std::cerr << RED_COLOR << "Error: Could not initialize curl" << RESET_COLOR << std::endl;
+            return results;
         }
         
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
-        return true;
+        // One target per distinct URL, planned before anything is sent
+        struct Target {
+            size_t platform;
+            std::string name;          // as the platform normalizes it
+            std::string url;
+            std::vector<size_t> variants;
+            size_t row;                // in `requested`
+        };
+        std::vector<Target> targets;
+        std::unordered_map<std::string, size_t> byURL;
+        std::unordered_map<std::string, size_t> byName;
+        std::string name;
+        std::string url;
+        orderPlatforms();
+        for (size_t index : order) {
+            const Platform& platform = platforms[index];
+            for (size_t i = 0; i < variants.size(); i++) {
+                if (!platform.normalize(variants[i], name)) {
+                    stats.invalid++;
+                    continue;
+                }
+                platform.buildURL(name, url);
+                auto existing = byURL.find(url);
+                if (existing != byURL.end()) {
+                    targets[existing->second].variants.push_back(i);
+                    stats.duplicates++;
+                    continue;
+                }
+                byURL[url] = targets.size();
+                auto row = byName.emplace(name, requested.size());
+                if (row.second) requested.push_back({name, 0, {}, 0, requested.size() + 1});
+                targets.push_back({index, name, url, {i}, row.first->second});
+            }
+        }
+        stats.checks = targets.size();
+        
+        std::cout << CYAN_COLOR << "\n🧬 Searching " << variants.size() << " variant(s) of: " << YELLOW_COLOR << variants[0]
+                  << RESET_COLOR << std::endl;
+        std::cout << BLUE_COLOR << "📊 " << stats.checks << " distinct URL(s) of " << stats.candidates << " ("
+                  << stats.invalid << " invalid for the platform, " << stats.duplicates << " duplicate)\n"
+                  << RESET_COLOR << std::endl;
+        
+        size_t current = 0;
+        auto complete = [&](const CheckOutcome& outcome) {
+            const Target& target = targets[outcome.job.user];
+            record(outcome, target.name);
+            for (size_t i : target.variants) {
+                if (outcome.cancelled) {
+                    results[i].unchecked++;
+                } else if (!outcome.skipped && outcome.error == CURLE_OK && outcome.found) {
+                    results[i].found.push_back({outcome.job.platform, outcome.job.url, outcome.responseCode});
+                }
+            }
+            UserSearch& row = requested[target.row];
+            if (outcome.cancelled) {
+                row.unchecked++;
+            } else if (!outcome.skipped && outcome.error == CURLE_OK && outcome.found) {
+                row.found.push_back({outcome.job.platform, outcome.job.url, outcome.responseCode});
+            }
+            if (outcome.cancelled) return;
+            current++;
+            std::cout << "\r" << MAGENTA_COLOR << "Progress: [" << current << "/" << targets.size() << "] "
+                      << "Checked " << outcome.job.platform << "..." << RESET_COLOR << std::flush;
+        };
+        
+        size_t nextTarget = 0;
+        auto next = [&](CheckJob& job) {
+            while (nextTarget < targets.size()) {
+                const Target& target = targets[nextTarget];
+                const Platform& platform = platforms[target.platform];
+                job.url = target.url;
+                job.platform = platform.name;
+                job.host = platform.host;
+                job.rule = &platform.rule;
+                job.revision = platform.revision;
+                job.user = nextTarget++;
+                
+                CheckOutcome cached;
+                if (cachedOutcome(platform, target.name, job, cached)) {
+                    complete(cached);
+                    continue;
+                }
+                return true;
+            }
+            return false;
+        };
+        
+        armDeadline();
+        engine->run(next, complete);
+        std::cout << "\n" << std::endl;
+        
+        // Targets the deadline kept from being sent at all
+        for (; nextTarget < targets.size(); nextTarget++) {
+            for (size_t i : targets[nextTarget].variants) results[i].unchecked++;
+            requested[targets[nextTarget].row].unchecked++;
+        }
+        auto byPlatform = [](const FoundProfile& a, const FoundProfile& b) { return a.platform < b.platform; };
+        for (auto& search : results) std::sort(search.found.begin(), search.found.end(), byPlatform);
+        for (auto& search : requested) std::sort(search.found.begin(), search.found.end(), byPlatform);
+        return results;
     }
     
-    std::vector<FoundProfile> searchUsername(const std::string& username) {
-        std::vector<FoundProfile> foundProfiles;
-        auto platforms = getPlatforms();
+    // Profiles found for `username`; `unchecked` in the result counts the
+    // checks a deadline cut off
+    UserSearch searchUsername(const std::string& username) {
+        UserSearch result = {username, 0, {}, 0, 0};
         
         std::cout << CYAN_COLOR << "\n🔍 Searching for username: " << YELLOW_COLOR << username << RESET_COLOR << std::endl;
         std::cout << BLUE_COLOR << "📊 Checking " << platforms.size() << " platforms...\n" << RESET_COLOR << std::endl;
         
-        int current = 0;
-        for (const auto& platform : platforms) {
+        bool pending = true;
+        auto nextUser = [&](std::string& name) {
+            if (!pending) return false;
+            name = username;
+            pending = false;
+            return true;
+        };
+        
+        size_t current = 0;
+        searchStream(nextUser, [&](UserSearch& search) { result = std::move(search); },
+                     [&](const CheckOutcome& outcome) {
+            if (outcome.cancelled) return;
             current++;
             
-            // Format URL with username
-            std::string formattedUrl;
-            size_t bufferSize = platform.second.length() + username.length() + 1;
-            char* buffer = new char[bufferSize];
-            snprintf(buffer, bufferSize, platform.second.c_str(), username.c_str());
-            formattedUrl = buffer;
-            delete[] buffer;
-            
             // Progress indicator
             std::cout << "\r" << MAGENTA_COLOR << "Progress: [" << current << "/" << platforms.size() << "] " 
-                      << "Checking " << platform.first << "..." << RESET_COLOR << std::flush;
+                      << "Checked " << outcome.job.platform << "..." << RESET_COLOR << std::flush;
             
-            long responseCode = 0;
-            if (checkURL(formattedUrl, responseCode)) {
-                if (verbose) {
-                    std::cout << "\n  " << platform.first << " -> " << responseCode << " (" << formattedUrl << ")";
-                }
-                
-                // Consider profile found if response is 200
-                if (responseCode == 200) {
-                    foundProfiles.push_back({platform.first, formattedUrl, responseCode});
-                    std::cout << "\n" << GREEN_COLOR << "  ✓ FOUND: " << platform.first << RESET_COLOR << std::endl;
-                }
+            if (outcome.error == CURLE_OK && outcome.found) {
+                std::cout << "\n" << GREEN_COLOR << "  ✓ FOUND: " << outcome.job.platform << RESET_COLOR << std::endl;
             }
-            
-            // Small delay to avoid overwhelming servers
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+        });
         
         std::cout << "\n" << std::endl;
-        return foundProfiles;
+        return result;
     }
 };
 
@@ -177,15 +570,52 @@ void printUsage(const char* programName) {
     std::cout << YELLOW_COLOR << "\nUsage: " << RESET_COLOR << programName << " [OPTIONS] <username>\n";
     std::cout << "\nOptions:\n";
     std::cout << "  -v, --verbose    Enable verbose output\n";
-    std::cout << "  -t, --timeout    Set timeout in seconds (default: 10)\n";
+    std::cout << "  -t, --timeout    Set timeout in seconds, the cap for adaptive timeouts (default: 10)\n";
+    std::cout << "  --timeout-factor Per-host timeout is p99 latency x FACTOR (default: 3, 0 disables)\n";
+    std::cout << "  --hedge          Send a duplicate request when one runs past its host's p95\n";
+    std::cout << "  --deadline       Stop after SECONDS and report partial results, likely hits first\n";
+    std::cout << "  -c, --concurrency Maximum requests in flight (default: 20)\n";
+    std::cout << "  --rate           Requests per second per host (default: 2)\n";
+    std::cout << "  --burst          Burst size per host (default: 2)\n";
+    std::cout << "  --platforms      Load the platform list from FILE instead of the built-in one\n";
+    std::cout << "  --dump-platforms Print the built-in platform list in database format\n";
+    std::cout << "  --max-body       Body bytes scanned for detection markers (default: 262144)\n";
+    std::cout << "  --http1          Disable HTTP/2 negotiation and multiplexing\n";
+    std::cout << "  --max-streams    Concurrent HTTP/2 streams per connection (default: 100)\n";
+    std::cout << "  --connect-to     Send requests for HOST:PORT to ADDR:PORT instead (repeatable)\n";
+    std::cout << "  --prefetch       Resolve and connect to all platform hosts before searching\n";
+    std::cout << "  -b, --batch      Read usernames from FILE (or - for stdin), one per line\n";
+    std::cout << "  --results        Store all results in compact binary FILE at the end of the run\n";
+    std::cout << "  --convert        Print a --results FILE, or export it with -j / -o\n";
+    std::cout << "  --journal        Journal a --batch run in DIR as it goes, so it can be resumed after a crash\n";
+    std::cout << "  --resume         Continue the run journaled in DIR, sending only the checks it is missing\n";
+    std::cout << "  --variants       Also search spelling variants of the username (john.doe, john_doe, JohnDoe...),\n";
+    std::cout << "                   checking each URL the platforms resolve them to only once\n";
+    std::cout << "  --variant-rules  Variant rules: separators[=CHARS], case, reverse (default: separators,case)\n";
+    std::cout << "  --coordinate     Shard the --batch into DIR and merge what --work processes return\n";
+    std::cout << "  --work           Check shards from a coordinator's DIR until all are done\n";
+    std::cout << "  --shard-size     Usernames per shard (default: 100)\n";
+    std::cout << "  --workers        Workers the per-host rate is split between, at most --burst; more wait for a free slot (default: 1)\n";
+    std::cout << "  --lease-timeout  Seconds without a worker heartbeat before its shard and slot are re-issued (default: 30)\n";
+    std::cout << "  --serve          Stay resident and answer queries on the Unix socket PATH\n";
     std::cout << "  -j, --json       Export results to JSON file\n";
     std::cout << "  -o, --output     Export results to TXT file\n";
+    std::cout << "  --cache-dir      Keep a persistent result cache in DIR\n";
+    std::cout << "  --max-age        Seconds a cached result stays fresh (default: 86400)\n";
+    std::cout << "  --refresh        Ignore cached results (they are still updated)\n";
+    std::cout << "  --breaker-threshold Consecutive DNS/connect/timeout failures before a host is skipped (default: 3, 0 disables)\n";
+    std::cout << "  --breaker-cooldown  Seconds before a skipped host is probed again (default: 600)\n";
+    std::cout << "  --stats          Print a per-phase timing summary (DNS, connect, TLS, TTFB) per host\n";
+    std::cout << "  --metrics        Write request metrics to FILE in Prometheus text format\n";
+    std::cout << "  --ndjson         Stream one JSON record per check to FILE while searching\n";
     std::cout << "  -h, --help       Show this help message\n";
     std::cout << "\nExample:\n";
     std::cout << "  " << programName << " johndoe\n";
     std::cout << "  " << programName << " -v -t 15 johndoe\n";
+    std::cout << "  " << programName << " -c 50 johndoe\n";
     std::cout << "  " << programName << " -j johndoe\n";
-    std::cout << "  " << programName << " -o results.txt johndoe\n" << std::endl;
+    std::cout << "  " << programName << " -o results.txt johndoe\n";
+    std::cout << "  " << programName << " --batch usernames.txt\n" << std::endl;
 }
 
 void printResults(const std::vector<FoundProfile>& profiles) {
@@ -213,7 +643,27 @@ void printResults(const std::vector<FoundProfile>& profiles) {
     std::cout << "└─────────────────────────┴────────────────────────────────────────────────────────┘\n" << std::endl;
 }
 
-void exportToJSON(const std::vector<FoundProfile>& profiles, const std::string& username) {
+void printIncomplete(size_t unchecked, size_t total) {
+    std::cout << YELLOW_COLOR << "⏱️  Deadline reached: " << unchecked << " of " << total
+              << " check(s) did not finish, results are incomplete" << RESET_COLOR << std::endl;
+}
+
+void printBatchResult(const UserSearch& search) {
+    std::string incomplete = search.unchecked ? " (incomplete, " + std::to_string(search.unchecked) + " unchecked)" : "";
+    if (search.found.empty()) {
+        std::cout << RED_COLOR << "✗ " << search.username << ": no profiles found" << incomplete << RESET_COLOR << std::endl;
+        return;
+    }
+    
+    std::cout << GREEN_COLOR << "✓ " << search.username << ": " << search.found.size() << " profile(s)" << incomplete
+              << RESET_COLOR << std::endl;
+    for (const auto& profile : search.found) {
+        std::cout << "    " << std::left << std::setw(23) << profile.platform << " " << profile.url << "\n";
+    }
+    std::cout << std::flush;
+}
+
+void exportToJSON(const std::vector<FoundProfile>& profiles, const std::string& username, size_t unchecked = 0) {
     std::string filename = username + "_results.json";
     std::ofstream file(filename);
     
@@ -226,6 +676,8 @@ void exportToJSON(const std::vector<FoundProfile>& profiles, const std::string&
     file << "  \"username\": \"" << username << "\",\n";
     file << "  \"search_date\": \"" << std::chrono::system_clock::now().time_since_epoch().count() << "\",\n";
     file << "  \"total_found\": " << profiles.size() << ",\n";
+    file << "  \"complete\": " << (unchecked ? "false" : "true") << ",\n";
+    file << "  \"unchecked\": " << unchecked << ",\n";
     file << "  \"profiles\": [\n";
     
     for (size_t i = 0; i < profiles.size(); i++) {
@@ -245,8 +697,9 @@ void exportToJSON(const std::vector<FoundProfile>& profiles, const std::string&
     std::cout << GREEN_COLOR << "📄 Results exported to: " << filename << RESET_COLOR << std::endl;
 }
 
-void exportToTXT(const std::vector<FoundProfile>& profiles, const std::string& username, const std::string& outputFile) {
-    std::ofstream file(outputFile);
+void exportToTXT(const std::vector<FoundProfile>& profiles, const std::string& username, const std::string& outputFile,
+                 bool append = false, size_t unchecked = 0) {
+    std::ofstream file(outputFile, append ? std::ios::app : std::ios::trunc);
     
     if (!file.is_open()) {
         std::cerr << RED_COLOR << "Error: Could not create TXT file " << outputFile << RESET_COLOR << std::endl;
@@ -257,7 +710,11 @@ void exportToTXT(const std::vector<FoundProfile>& profiles, const std::string& u
     file << "========================\n\n";
     file << "Username: " << username << "\n";
     file << "Search Date: " << std::chrono::system_clock::now().time_since_epoch().count() << "\n";
-    file << "Total Profiles Found: " << profiles.size() << "\n\n";
+    file << "Total Profiles Found: " << profiles.size() << "\n";
+    if (unchecked) {
+        file << "Status: INCOMPLETE (" << unchecked << " checks did not finish before the deadline)\n";
+    }
+    file << "\n";
     
     if (profiles.empty()) {
         file << "No profiles found for this username.\n";
@@ -275,95 +732,1366 @@ void exportToTXT(const std::vector<FoundProfile>& profiles, const std::string& u
     
     file.close();
     
-    std::cout << GREEN_COLOR << "📄 Results exported to: " << outputFile << RESET_COLOR << std::endl;
+    if (!append) {
+        std::cout << GREEN_COLOR << "📄 Results exported to: " << outputFile << RESET_COLOR << std::endl;
+    }
 }
 
-int main(int argc, char* argv[]) {
-    bool verbose = false;
-    int timeout = 10;
-    std::string username;
-    bool exportJSON = false;
-    std::string outputFile = "";
+bool isValidUsername(const std::string& username) {
+    return username.length() >= 2 && username.length() <= 50;
+}
+
+void printConnectionStats(const ShareStats& stats) {
+    std::cout << BLUE_COLOR << "🔗 Connection cache: DNS ~" << stats.dnsHits << " hit(s) / ~" << stats.dnsMisses
+              << " miss(es) (estimated), connections " << stats.connectionsReused << " reused / " << stats.connectionsOpened
+              << " opened" << RESET_COLOR << std::endl;
+}
+
+void printProtocolStats(const std::map<std::string, HostProtocolStats>& hosts) {
+    if (hosts.empty()) return;
     
-    // Parse command line arguments
-    for (int i = 1; i < argc; i++) {
-        std::string arg = argv[i];
+    std::cout << CYAN_COLOR << "\n📡 Protocols per host:" << RESET_COLOR << "\n";
+    std::cout << "  " << std::left << std::setw(32) << "Host" << std::setw(10) << "Protocol"
+              << std::right << std::setw(10) << "Requests" << std::setw(13) << "Connections" << std::setw(14) << "Streams/conn" << "\n";
+    for (const auto& entry : hosts) {
+        const HostProtocolStats& stats = entry.second;
+        std::string protocol = stats.http3 ? "HTTP/3" : stats.http2 ? "HTTP/2" : "HTTP/1.1";
+        if ((stats.http1 > 0) + (stats.http2 > 0) + (stats.http3 > 0) > 1) protocol = "mixed";
         
-        if (arg == "-h" || arg == "--help") {
-            printBanner();
-            printUsage(argv[0]);
-            return 0;
-        } else if (arg == "-v" || arg == "--verbose") {
-            verbose = true;
-        } else if (arg == "-t" || arg == "--timeout") {
-            if (i + 1 < argc) {
-                timeout = std::atoi(argv[++i]);
-                if (timeout <= 0) {
-                    std::cerr << RED_COLOR << "Error: Timeout must be a positive integer" << RESET_COLOR << std::endl;
-                    return 1;
-                }
-            } else {
-                std::cerr << RED_COLOR << "Error: --timeout requires a value" << RESET_COLOR << std::endl;
-                return 1;
-            }
-        } else if (arg == "-j" || arg == "--json") {
-            exportJSON = true;
-        } else if (arg == "-o" || arg == "--output") {
-            if (i + 1 < argc) {
-                outputFile = argv[++i];
-            } else {
-                std::cerr << RED_COLOR << "Error: --output requires a filename" << RESET_COLOR << std::endl;
-                return 1;
-            }
-        } else if (arg[0] != '-') {
-            username = arg;
-        } else {
-            std::cerr << RED_COLOR << "Error: Unknown option " << arg << RESET_COLOR << std::endl;
-            printUsage(argv[0]);
-            return 1;
-        }
+        std::cout << "  " << std::left << std::setw(32) << entry.first << std::setw(10) << protocol
+                  << std::right << std::setw(10) << stats.transfers << std::setw(13) << stats.connections.size()
+                  << std::setw(14) << std::fixed << std::setprecision(1) << stats.streamsPerConnection() << "\n";
     }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+void printCacheStats(const ResultCache& cache) {
+    size_t lookups = cache.lookupCount();
+    double ratio = lookups ? 100.0 * cache.hitCount() / lookups : 0.0;
+    std::cout << BLUE_COLOR << "💾 Result cache: " << cache.hitCount() << " hit(s) / " << lookups << " lookup(s) ("
+              << std::fixed << std::setprecision(1) << ratio << "%)" << std::defaultfloat << RESET_COLOR << std::endl;
+}
+
+void printHealthStats(const HostHealth& health) {
+    if (health.skippedCount() == 0 && health.unhealthyCount() == 0) return;
+    std::cout << YELLOW_COLOR << "⚡ Circuit breaker: " << health.skippedCount() << " check(s) skipped, "
+              << health.unhealthyCount() << " host(s) unhealthy" << RESET_COLOR << std::endl;
+}
+
+void printLatencyStats(const LatencyTracker& latency, long capSeconds) {
+    const auto& hosts = latency.histograms();
+    if (hosts.empty()) return;
     
-    // Show banner
-    printBanner();
+    std::cout << CYAN_COLOR << "\n⏲️  Latency per host:" << RESET_COLOR << "\n";
+    std::cout << "  " << std::left << std::setw(32) << "Host" << std::right << std::setw(9) << "Samples"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms" << std::setw(10) << "p99 ms" << std::setw(12) << "Timeout ms" << "\n";
+    for (const auto& entry : hosts) {
+        const LatencyHistogram& histogram = entry.second;
+        std::cout << "  " << std::left << std::setw(32) << entry.first << std::right << std::setw(9) << histogram.count()
+                  << std::setw(10) << (long)(histogram.percentile(0.50) * 1000) << std::setw(10) << (long)(histogram.percentile(0.95) * 1000)
+                  << std::setw(10) << (long)(histogram.percentile(0.99) * 1000)
+                  << std::setw(12) << latency.timeoutMs(entry.first, capSeconds * 1000) << "\n";
+    }
+    std::cout << std::endl;
+}
+
+void printHedgeStats(size_t sent, size_t won, size_t retries) {
+    if (sent > 0) {
+        std::cout << BLUE_COLOR << "🏁 Hedged requests: " << sent << " sent, " << won << " answered first" << RESET_COLOR << std::endl;
+    }
+    if (retries > 0) {
+        std::cout << BLUE_COLOR << "🔁 Retried " << retries << " check(s) that exceeded their adaptive timeout" << RESET_COLOR << std::endl;
+    }
+}
+
+void printTimingStats(const RunMetrics& metrics) {
+    const PhaseStats& total = metrics.total();
+    if (total.requests == 0) return;
     
-    // Check if username is provided
-    if (username.empty()) {
-        std::cerr << RED_COLOR << "Error: Username is required!" << RESET_COLOR << std::endl;
-        printUsage(argv[0]);
+    std::cout << CYAN_COLOR << "\n📈 Request phases (" << total.requests << " request(s), " << total.errors << " error(s), "
+              << total.bytes / 1024 << " KiB received):" << RESET_COLOR << "\n";
+    std::cout << "  " << std::left << std::setw(10) << "Phase" << std::right << std::setw(9) << "Count" << std::setw(10) << "Mean ms"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms" << std::setw(10) << "p99 ms" << "\n";
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        if (total.counts[phase] == 0) continue;
+        std::cout << "  " << std::left << std::setw(10) << PHASE_NAMES[phase] << std::right << std::setw(9) << total.counts[phase]
+                  << std::setw(10) << (long)(total.sums[phase] / total.counts[phase] * 1000)
+                  << std::setw(10) << (long)(total.histograms[phase].percentile(0.50) * 1000)
+                  << std::setw(10) << (long)(total.histograms[phase].percentile(0.95) * 1000)
+                  << std::setw(10) << (long)(total.histograms[phase].percentile(0.99) * 1000) << "\n";
+    }
+    
+    // Slowest hosts first
+    std::vector<std::pair<std::string, const PhaseStats*>> hosts;
+    for (const auto& entry : metrics.hosts()) hosts.push_back({entry.first, &entry.second});
+    std::sort(hosts.begin(), hosts.end(), [](const std::pair<std::string, const PhaseStats*>& a, const std::pair<std::string, const PhaseStats*>& b) {
+        return a.second->histograms[PHASE_TOTAL].percentile(0.95) > b.second->histograms[PHASE_TOTAL].percentile(0.95);
+    });
+    
+    auto p50 = [](const PhaseStats& stats, Phase phase) {
+        return stats.counts[phase] ? std::to_string((long)(stats.histograms[phase].percentile(0.50) * 1000)) : std::string("-");
+    };
+    std::cout << "\n  " << std::left << std::setw(32) << "Host (p50 ms per phase)" << std::right << std::setw(6) << "Reqs"
+              << std::setw(7) << "DNS" << std::setw(9) << "Connect" << std::setw(7) << "TLS" << std::setw(7) << "TTFB"
+              << std::setw(11) << "Total p95" << std::setw(8) << "KiB" << std::setw(8) << "Errors" << "\n";
+    for (const auto& entry : hosts) {
+        const PhaseStats& stats = *entry.second;
+        std::cout << "  " << std::left << std::setw(32) << entry.first << std::right << std::setw(6) << stats.requests
+                  << std::setw(7) << p50(stats, PHASE_DNS) << std::setw(9) << p50(stats, PHASE_CONNECT)
+                  << std::setw(7) << p50(stats, PHASE_TLS) << std::setw(7) << p50(stats, PHASE_TTFB)
+                  << std::setw(11) << (long)(stats.histograms[PHASE_TOTAL].percentile(0.95) * 1000)
+                  << std::setw(8) << stats.bytes / 1024 << std::setw(8) << stats.errors << "\n";
+    }
+    std::cout << std::endl;
+}
+
+// Print the --stats table and write the --metrics file, whichever were asked for
+void reportMetrics(const RunMetrics& metrics, bool showStats, const std::string& metricsFile) {
+    if (showStats) {
+        printTimingStats(metrics);
+    }
+    if (!metricsFile.empty()) {
+        if (metrics.writePrometheus(metricsFile)) {
+            std::cout << GREEN_COLOR << "📊 Metrics written to: " << metricsFile << RESET_COLOR << std::endl;
+        } else {
+            std::cerr << RED_COLOR << "Error: Could not write metrics file " << metricsFile << RESET_COLOR << std::endl;
+        }
+    }
+}
+
+// Optional services shared by single and batch searches, set up in main
+struct RunServices {
+    NDJSONSink* sink = nullptr;
+    ResultCache* cache = nullptr;
+    long maxAge = 0;
+    bool refresh = false;
+    HostHealth* health = nullptr;
+    LatencyTracker* latency = nullptr;
+    RunMetrics* metrics = nullptr;
+    bool showStats = false;
+    std::string metricsFile;
+    PlatformHistory* history = nullptr;
+    double deadline = 0;
+    ResultStore* results = nullptr;
+    RunJournal* journal = nullptr;
+};
+
+// Keep `search` in the compact store; hits on platforms outside its table are dropped
+void storeResult(ResultStore& results, const UserSearch& search) {
+    std::vector<ResultStore::Hit> hits;
+    for (const auto& profile : search.found) {
+        uint32_t id;
+        if (results.platformId(profile.platform, id)) hits.push_back({id, (uint16_t)profile.responseCode});
+    }
+    results.add(search.username, std::move(hits), search.unchecked);
+}
+
+void saveResults(const ResultStore& results, const std::string& path) {
+    if (!results.save(path)) {
+        std::cerr << RED_COLOR << "Error: Could not write " << path << RESET_COLOR << std::endl;
+        return;
+    }
+    std::cout << GREEN_COLOR << "📦 " << results.size() << " result(s) stored in " << path << " ("
+              << std::fixed << std::setprecision(1) << results.bytes() / (1024.0 * 1024.0) << " MB in memory)"
+              << std::defaultfloat << RESET_COLOR << std::endl;
+}
+
+// Rebuild every username of `results` as a UserSearch, URLs included
+void forEachStored(const ResultStore& results, const std::function<void(UserSearch&)>& onUser) {
+    std::vector<ResultStore::Hit> hits;
+    for (size_t user = 0; user < results.size(); user++) {
+        UserSearch search = {results.username(user), 0, {}, results.uncheckedCount(user), user + 1};
+        results.hits(user, hits);
+        for (const auto& hit : hits) {
+            search.found.push_back({results.platformName(hit.platform), results.url(hit.platform, search.username), hit.status});
+        }
+        onUser(search);
+    }
+}
+
+// Turn a binary result file back into the JSON/TXT exports, or print it
+int runConvert(const std::string& path, bool exportJSON, const std::string& outputFile) {
+    ResultStore results;
+    std::string error;
+    if (!results.load(path, error)) {
+        std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
         return 1;
     }
+    if (!outputFile.empty()) {
+        std::ofstream(outputFile, std::ios::trunc);
+    }
     
-    // Validate username
-    if (username.length() < 2 || username.length() > 50) {
-        std::cerr << RED_COLOR << "Error: Username must be between 2 and 50 characters!" << RESET_COLOR << std::endl;
+    forEachStored(results, [&](UserSearch& search) {
+        if (exportJSON) {
+            exportToJSON(search.found, search.username, search.unchecked);
+        }
+        if (!outputFile.empty()) {
+            exportToTXT(search.found, search.username, outputFile, true, search.unchecked);
+        }
+        if (!exportJSON && outputFile.empty()) {
+            printBatchResult(search);
+        }
+    });
+    if (!outputFile.empty()) {
+        std::cout << GREEN_COLOR << "📄 Results exported to: " << outputFile << RESET_COLOR << std::endl;
+    }
+    return 0;
+}
+
+void attachServices(OSINTChecker& checker, const RunServices& services) {
+    checker.setSink(services.sink);
+    if (services.cache) {
+        checker.setCache(services.cache, services.maxAge, services.refresh);
+    }
+    checker.setHealth(services.health);
+    checker.setLatency(services.latency);
+    checker.setMetrics(services.metrics);
+    checker.setHistory(services.history);
+    checker.setDeadline(services.deadline);
+    checker.setJournal(services.journal);
+}
+
+// End-of-run statistics common to single and batch searches
+void printRunStats(const OSINTChecker& checker, const RunServices& services, bool verbose, long timeout) {
+    if (verbose) {
+        printConnectionStats(checker.connectionStats());
+        printProtocolStats(checker.protocolStats());
+        if (services.latency) printLatencyStats(*services.latency, timeout);
+    }
+    if (services.metrics) {
+        reportMetrics(*services.metrics, services.showStats, services.metricsFile);
+    }
+    printHedgeStats(checker.hedgeCount(), checker.hedgeWins(), checker.retryCount());
+    if (services.cache) {
+        printCacheStats(*services.cache);
+    }
+    if (services.health) {
+        printHealthStats(*services.health);
+    }
+}
+
+int runBatch(const std::string& batchFile, bool verbose, const EngineOptions& options, const PlatformTable& platforms, bool prefetch,
+             bool exportJSON, const std::string& outputFile, const RunServices& services) {
+    UsernameReader reader(batchFile);
+    if (!reader.isOpen()) {
+        std::cerr << RED_COLOR << "Error: Could not open batch file " << batchFile << RESET_COLOR << std::endl;
         return 1;
     }
     
-    // Create OSINT checker instance
-    OSINTChecker checker(verbose, timeout);
+    if (!outputFile.empty()) {
+        // Start from an empty file; each username appends its own section
+        std::ofstream(outputFile, std::ios::trunc);
+    }
     
-    // Start search
-    auto startTime = std::chrono::high_resolution_clock::now();
-    auto foundProfiles = checker.searchUsername(username);
-    auto endTime = std::chrono::high_resolution_clock::now();
+    OSINTChecker checker(verbose, options, platforms);
+    attachServices(checker, services);
+    if (prefetch) {
+        checker.prefetch();
+    }
     
-    // Calculate duration
-    auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    std::cout << CYAN_COLOR << "\n🔍 Batch search from: " << YELLOW_COLOR << batchFile << RESET_COLOR << std::endl;
+    std::cout << BLUE_COLOR << "📊 Checking " << checker.platformCount() << " platforms per username...\n" << RESET_COLOR << std::endl;
     
-    // Print results
-    printResults(foundProfiles);
+    size_t usernames = 0;
+    size_t withProfiles = 0;
+    auto nextUser = [&](std::string& name) {
+        while (reader.next(name)) {
+            if (isValidUsername(name)) return true;
+            std::cerr << YELLOW_COLOR << "⚠️  Skipping line " << reader.line() << ": username must be between 2 and 50 characters"
+                      << RESET_COLOR << std::endl;
+        }
+        return false;
+    };
     
-    // Export results if requested
-    if (exportJSON) {
-        exportToJSON(foundProfiles, username);
-    }
+    auto report = [&](UserSearch& search) {
+        usernames++;
+        if (!search.found.empty()) withProfiles++;
+        
+        printBatchResult(search);
+        if (services.results) {
+            storeResult(*services.results, search);
+        }
+        if (exportJSON) {
+            exportToJSON(search.found, search.username, search.unchecked);
+        }
+        if (!outputFile.empty()) {
+            exportToTXT(search.found, search.username, outputFile, true, search.unchecked);
+        }
+    };
     
-    if (!outputFile.empty()) {
-        exportToTXT(foundProfiles, username, outputFile);
+    // A resumed run first sends the checks its checkpoint is missing, then
+    // reports the usernames the checkpoint covers
+    if (services.journal && services.journal->missingCount() > 0) {
+        size_t missing = services.journal->missingCount();
+        std::cout << CYAN_COLOR << "📒 Sending " << missing << " check(s) again that failed or were skipped before"
+                  << RESET_COLOR << std::endl;
+        size_t answered = checker.retryJournaled();
+        std::cout << BLUE_COLOR << "📒 " << answered << " of " << missing << " answered" << RESET_COLOR << std::endl;
+    }
+    if (services.journal && services.journal->checkpoint().size() > 0) {
+        const ResultStore& checkpoint = services.journal->checkpoint();
+        std::cout << CYAN_COLOR << "📒 Resuming: " << checkpoint.size() << " username(s) from the checkpoint, "
+                  << services.journal->journaledChecks() << " check(s) from the journal\n" << RESET_COLOR << std::endl;
+        bool matches = true;
+        forEachStored(checkpoint, [&](UserSearch& search) {
+            std::string name;
+            matches = matches && nextUser(name) && name == search.username;
+            if (matches) report(search);
+        });
+        if (!matches) {
+            std::cerr << RED_COLOR << "Error: " << batchFile << " does not match the journal's checkpoint" << RESET_COLOR << std::endl;
+            return 1;
+        }
     }
     
-    std::cout << BLUE_COLOR << "⏱️  Search completed in " << duration.count() << " seconds" << RESET_COLOR << std::endl;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    bool ok = checker.searchStream(nextUser, report);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    
+    std::cout << BLUE_COLOR << "\n⏱️  Checked " << usernames << " username(s) in " << duration.count() << " seconds, "
+              << withProfiles << " with profiles" << RESET_COLOR << std::endl;
+    if (services.journal) {
+        if (!services.journal->close()) {
+            std::cerr << RED_COLOR << "Error: Could not write the checkpoint in " << services.journal->path() << RESET_COLOR << std::endl;
+        } else {
+            std::cout << BLUE_COLOR << "📒 Journal complete in " << services.journal->path() << " ("
+                      << services.journal->recalledChecks() << " check(s) answered from it)" << RESET_COLOR << std::endl;
+        }
+    }
+    if (checker.deadlinePassed()) {
+        std::cout << YELLOW_COLOR << "⏱️  Deadline reached: usernames after the last one listed were not checked"
+                  << RESET_COLOR << std::endl;
+    }
+    printRunStats(checker, services, verbose, options.timeout);
+    if (!outputFile.empty()) {
+        std::cout << GREEN_COLOR << "📄 Results exported to: " << outputFile << RESET_COLOR << std::endl;
+    }
+    std::cout << YELLOW_COLOR << "⚠️  Remember: This tool is for educational and legitimate research purposes only!" << RESET_COLOR << std::endl;
+    
+    return ok ? 0 : 1;
+}
+
+// --variants: search spelling variants of each identity from `nextIdentity`
+// together, so URLs they share are checked once
+int runVariants(const std::function<bool(std::string&)>& nextIdentity, const VariantRules& rules, bool verbose,
+                const EngineOptions& options, const PlatformTable& platforms, bool prefetch, bool exportJSON,
+                const std::string& outputFile, const RunServices& services) {
+    if (!outputFile.empty()) {
+        std::ofstream(outputFile, std::ios::trunc);
+    }
+    
+    OSINTChecker checker(verbose, options, platforms);
+    attachServices(checker, services);
+    if (prefetch) {
+        checker.prefetch();
+    }
+    
+    size_t candidates = 0;
+    size_t checks = 0;
+    std::string identity;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    while (nextIdentity(identity)) {
+        std::vector<std::string> variants;
+        for (const auto& variant : expandVariants(identity, rules)) {
+            if (isValidUsername(variant)) variants.push_back(variant);
+        }
+        if (variants.empty()) {
+            std::cerr << YELLOW_COLOR << "⚠️  Skipping " << identity << ": username must be between 2 and 50 characters"
+                      << RESET_COLOR << std::endl;
+            continue;
+        }
+        
+        VariantStats stats;
+        std::vector<UserSearch> requested;
+        std::vector<UserSearch> results = checker.searchVariants(variants, stats, requested);
+        candidates += stats.candidates;
+        checks += stats.checks;
+        
+        // The result file rebuilds URLs from the stored name, so it keeps
+        // the names that were actually requested, not the variants
+        if (services.results) {
+            for (const auto& search : requested) storeResult(*services.results, search);
+        }
+        for (const auto& search : results) {
+            printBatchResult(search);
+            if (exportJSON) {
+                exportToJSON(search.found, search.username, search.unchecked);
+            }
+            if (!outputFile.empty()) {
+                exportToTXT(search.found, search.username, outputFile, true, search.unchecked);
+            }
+        }
+        if (checker.deadlinePassed()) break;
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - startTime);
+    
+    std::cout << BLUE_COLOR << "\n⏱️  Sent " << checks << " check(s) for " << candidates << " variant/platform pair(s) in "
+              << duration.count() << " seconds" << RESET_COLOR << std::endl;
+    if (checker.deadlinePassed()) {
+        std::cout << YELLOW_COLOR << "⏱️  Deadline reached: identities after the last one listed were not checked"
+                  << RESET_COLOR << std::endl;
+    }
+    printRunStats(checker, services, verbose, options.timeout);
+    if (!outputFile.empty()) {
+        std::cout << GREEN_COLOR << "📄 Results exported to: " << outputFile << RESET_COLOR << std::endl;
+    }
+    std::cout << YELLOW_COLOR << "⚠️  Remember: This tool is for educational and legitimate research purposes only!" << RESET_COLOR << std::endl;
+    return 0;
+}
+
+// Per-username reply of --serve: the profiles found and whether the search was complete
+std::string formatUserRecord(const UserSearch& search) {
+    std::string record = "{\"username\":\"" + jsonEscape(search.username) + "\",\"found\":[";
+    for (size_t i = 0; i < search.found.size(); i++) {
+        if (i > 0) record += ",";
+        record += "{\"platform\":\"" + jsonEscape(search.found[i].platform) + "\",\"url\":\"" + jsonEscape(search.found[i].url) +
+                  "\",\"status\":" + std::to_string(search.found[i].responseCode) + "}";
+    }
+    record += std::string("],\"complete\":") + (search.unchecked ? "false" : "true") +
+              ",\"unchecked\":" + std::to_string(search.unchecked) + "}";
+    return record;
+}
+
+// Set by SIGINT/SIGTERM; --serve finishes the checks in flight and exits
+static volatile sig_atomic_t stopServing = 0;
+
+void onStopSignal(int) { stopServing = 1; }
+
+// Stay resident and answer queries on a Unix socket. One checker serves
+// every client, so DNS answers, TLS sessions, connections, rate limits
+// and latency history stay warm between queries.
+int runServe(const std::string& socketPath, bool verbose, const EngineOptions& options, const PlatformTable& platforms,
+             bool prefetch, const RunServices& services, const std::function<void()>& saveState) {
+    OSINTChecker checker(verbose, options, platforms);
+    attachServices(checker, services);
+    if (prefetch) {
+        checker.prefetch();
+    }
+    
+    QueryServer server;
+    std::string error;
+    if (!server.start(socketPath, error)) {
+        std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+        return 1;
+    }
+    server.setWakeup([&checker] { checker.wakeup(); });
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+    
+    std::cout << CYAN_COLOR << "\n🛰️  Serving " << checker.platformCount() << " platforms on " << YELLOW_COLOR << socketPath
+              << RESET_COLOR << CYAN_COLOR << " (Ctrl+C to stop)" << RESET_COLOR << std::endl;
+    
+    // Which client each username of the current search belongs to, by UserSearch::id
+    std::unordered_map<size_t, std::pair<std::shared_ptr<QueryClient>, std::string>> owners;
+    size_t sequence = 0;
+    
+    auto nextUser = [&](std::string& name) {
+        std::shared_ptr<QueryClient> client;
+        while (!stopServing && server.next(client, name)) {
+            if (!isValidUsername(name)) {
+                server.send(client, "{\"username\":\"" + jsonEscape(name) +
+                                    "\",\"error\":\"username must be between 2 and 50 characters\"}");
+                server.finish(client);
+                continue;
+            }
+            owners[++sequence] = {client, name};
+            return true;
+        }
+        return false;
+    };
+    auto onCheck = [&](const CheckOutcome& outcome) {
+        const auto& owner = owners[outcome.job.user];
+        if (server.wantsChecks(owner.first)) {
+            server.send(owner.first, formatCheckRecord(owner.second, outcome));
+        }
+    };
+    auto onUser = [&](UserSearch& search) {
+        auto owner = owners.find(search.id);
+        server.send(owner->second.first, formatUserRecord(search));
+        server.finish(owner->second.first);
+        owners.erase(owner);
+    };
+    
+    // Each busy period is one streaming search; idle periods persist state
+    while (!stopServing) {
+        if (!server.waitForWork(200)) continue;
+        sequence = 0;
+        checker.searchStream(nextUser, onUser, onCheck);
+        saveState();
+    }
+    
+    server.stop();
+    std::cout << BLUE_COLOR << "\n🛰️  Served " << server.queryCount() << " quer" << (server.queryCount() == 1 ? "y" : "ies")
+              << RESET_COLOR << std::endl;
+    printRunStats(checker, services, verbose, options.timeout);
+    return 0;
+}
+
+// Settings of --coordinate
+struct CoordinatorOptions {
+    size_t shardSize = 100;    // usernames per shard
+    int workers = 1;           // worker slots the per-host rate is split between
+    long leaseTimeout = 30;    // seconds without a heartbeat before a shard or slot is re-issued
+};
+
+// Split a batch into shards in a work directory, wait for --work processes
+// to check them and merge their results as each shard finishes. Restarted
+// on the same directory, it resumes merging the existing job.
+int runCoordinator(const std::string& directory, const std::string& batchFile, const CoordinatorOptions& coordinator,
+                   const EngineOptions& options, const std::string& platformDatabase, bool exportJSON,
+                   const std::string& outputFile, const std::string& resultsFile) {
+    WorkDirectory work(directory);
+    std::string error;
+    ShardJob job;
+    
+    if (work.hasJob()) {
+        if (!work.readJob(job, error)) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+        std::cout << CYAN_COLOR << "\n🧩 Resuming job in " << directory << " (" << job.shards << " shard(s))" << RESET_COLOR << std::endl;
+    } else {
+        if (batchFile.empty()) {
+            std::cerr << RED_COLOR << "Error: --coordinate needs --batch for a new job" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        // Every worker needs a whole request of burst, or the shares would add up to more than --burst
+        if (coordinator.workers > options.hostBurst) {
+            std::cerr << RED_COLOR << "Error: --workers " << coordinator.workers << " needs a --burst of at least "
+                      << coordinator.workers << " (got " << options.hostBurst << ")" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        UsernameReader reader(batchFile);
+        if (!reader.isOpen()) {
+            std::cerr << RED_COLOR << "Error: Could not open batch file " << batchFile << RESET_COLOR << std::endl;
+            return 1;
+        }
+        if (!work.create(error) || !work.writePlatforms(platformDatabase)) {
+            std::cerr << RED_COLOR << "Error: " << (error.empty() ? "Could not write " + work.platformsPath() : error)
+                      << RESET_COLOR << std::endl;
+            return 1;
+        }
+        
+        std::string shard;
+        size_t inShard = 0;
+        size_t usernames = 0;
+        std::string name;
+        auto flush = [&]() {
+            if (inShard == 0) return true;
+            bool ok = work.writeShard(job.shards++, shard);
+            shard.clear();
+            inShard = 0;
+            return ok;
+        };
+        while (reader.next(name)) {
+            if (!isValidUsername(name)) {
+                std::cerr << YELLOW_COLOR << "⚠️  Skipping line " << reader.line() << ": username must be between 2 and 50 characters"
+                          << RESET_COLOR << std::endl;
+                continue;
+            }
+            shard += name + "\n";
+            usernames++;
+            if (++inShard == coordinator.shardSize && !flush()) break;
+        }
+        job.workers = coordinator.workers;
+        job.hostRate = options.hostRate;
+        job.hostBurst = options.hostBurst;
+        // Publishing the job is what lets workers start
+        if (!flush() || !work.publish(job)) {
+            std::cerr << RED_COLOR << "Error: Could not write shards to " << directory << RESET_COLOR << std::endl;
+            return 1;
+        }
+        std::cout << CYAN_COLOR << "\n🧩 " << usernames << " username(s) in " << job.shards << " shard(s) in " << directory
+                  << RESET_COLOR << std::endl;
+    }
+    // Workers check against the job's platforms, not this run's --platforms
+    PlatformTable platforms;
+    if (!platforms.loadFile(work.platformsPath(), error)) {
+        std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+        return 1;
+    }
+    ResultStore merged(platforms);
+    
+    std::cout << BLUE_COLOR << "📡 Start up to " << job.workers << " worker(s) with: yougoldberg --work " << directory
+              << RESET_COLOR << "\n" << std::endl;
+    
+    if (!outputFile.empty()) {
+        std::ofstream(outputFile, std::ios::trunc);
+    }
+    
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<bool> mergedShards(job.shards, false);
+    size_t remaining = job.shards;
+    size_t usernames = 0;
+    size_t withProfiles = 0;
+    size_t reissued = 0;
+    
+    while (remaining > 0) {
+        bool progressed = false;
+        for (int slot = 0; slot < job.workers; slot++) {
+            long age = work.slotAge(slot);
+            if (age > coordinator.leaseTimeout) {
+                std::cout << YELLOW_COLOR << "♻️  Freeing worker slot " << slot << ": " << work.slotOwner(slot)
+                          << " silent for " << age << " seconds" << RESET_COLOR << std::endl;
+                work.releaseSlot(slot);
+            }
+        }
+        for (size_t shard = 0; shard < job.shards; shard++) {
+            if (mergedShards[shard]) continue;
+            
+            if (!work.isDone(shard)) {
+                long age = work.leaseAge(shard);
+                if (age > coordinator.leaseTimeout) {
+                    std::cout << YELLOW_COLOR << "♻️  Re-issuing shard " << shard << ": " << work.leaseOwner(shard)
+                              << " silent for " << age << " seconds" << RESET_COLOR << std::endl;
+                    work.reissue(shard);
+                    reissued++;
+                }
+                continue;
+            }
+            
+            ResultStore results;
+            if (!results.load(work.resultPath(shard), error)) {
+                std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+                return 1;
+            }
+            forEachStored(results, [&](UserSearch& search) {
+                usernames++;
+                if (!search.found.empty()) withProfiles++;
+                printBatchResult(search);
+                if (!resultsFile.empty()) {
+                    storeResult(merged, search);
+                }
+                if (exportJSON) {
+                    exportToJSON(search.found, search.username, search.unchecked);
+                }
+                if (!outputFile.empty()) {
+                    exportToTXT(search.found, search.username, outputFile, true, search.unchecked);
+                }
+            });
+            mergedShards[shard] = true;
+            remaining--;
+            progressed = true;
+        }
+        if (!progressed && remaining > 0) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+    work.markComplete();
+    
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << BLUE_COLOR << "\n⏱️  Merged " << usernames << " username(s) from " << job.shards << " shard(s) in " << seconds
+              << " seconds, " << withProfiles << " with profiles, " << reissued << " lease(s) re-issued" << RESET_COLOR << std::endl;
+    if (!outputFile.empty()) {
+        std::cout << GREEN_COLOR << "📄 Results exported to: " << outputFile << RESET_COLOR << std::endl;
+    }
+    if (!resultsFile.empty()) {
+        saveResults(merged, resultsFile);
+    }
+    return 0;
+}
+
+// Keep claiming shards from a coordinator's work directory until every
+// shard is done. The per-host rate is this worker's share of the job's rate;
+// a worker holds one of the job's worker slots while it runs, so workers
+// started beyond --workers wait for a slot instead of exceeding the rate.
+int runWorker(const std::string& directory, bool verbose, EngineOptions options, bool prefetch, const RunServices& services) {
+    WorkDirectory work(directory);
+    ShardJob job;
+    std::string error;
+    while (!work.readJob(job, error)) {
+        if (work.hasJob()) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    
+    PlatformTable platforms;
+    if (!platforms.loadFile(work.platformsPath(), error)) {
+        std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+        return 1;
+    }
+    options.hostRate = job.hostRate / job.workers;
+    options.hostBurst = job.hostBurst / job.workers;
+    
+    std::string worker = WorkDirectory::workerId();
+    int slot = -1;
+    bool announced = false;
+    while (slot < 0 && !work.isComplete()) {
+        for (int candidate = 0; candidate < job.workers && slot < 0; candidate++) {
+            if (work.claimSlot(candidate, worker)) slot = candidate;
+        }
+        if (slot >= 0) break;
+        if (!announced) {
+            std::cout << YELLOW_COLOR << "⏳ All " << job.workers << " worker slot(s) of " << directory
+                      << " are taken; waiting for one to free up" << RESET_COLOR << std::endl;
+            announced = true;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    if (slot < 0) {
+        std::cout << BLUE_COLOR << "\n⏱️  Job in " << directory << " is already complete" << RESET_COLOR << std::endl;
+        return 0;
+    }
+    
+    // Heartbeat from a thread of its own, so a slow host cannot make a live
+    // worker look dead: the slot for the whole run, the shard while one is held
+    std::mutex mutex;
+    std::condition_variable stop;
+    bool stopping = false;
+    size_t heldShard = SIZE_MAX;
+    std::thread heartbeat([&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop.wait_for(lock, std::chrono::seconds(2), [&] { return stopping; })) {
+            work.heartbeatSlot(slot);
+            if (heldShard != SIZE_MAX) work.heartbeat(heldShard);
+        }
+    });
+    auto hold = [&](size_t shard) {
+        std::lock_guard<std::mutex> guard(mutex);
+        heldShard = shard;
+    };
+    auto leave = [&] {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            stopping = true;
+        }
+        stop.notify_one();
+        heartbeat.join();
+        work.releaseSlot(slot);
+    };
+    
+    OSINTChecker checker(verbose, options, platforms);
+    attachServices(checker, services);
+    if (prefetch) {
+        checker.prefetch();
+    }
+    
+    std::cout << CYAN_COLOR << "\n🔧 Worker " << worker << " in slot " << slot << " of " << directory << ": " << job.shards
+              << " shard(s), " << options.hostRate << " request(s)/s per host" << RESET_COLOR << std::endl;
+    
+    size_t processed = 0;
+    size_t usernames = 0;
+    while (!work.isComplete()) {
+        bool pending = false;
+        bool claimed = false;
+        for (size_t shard = 0; shard < job.shards; shard++) {
+            if (work.isDone(shard)) continue;
+            pending = true;
+            if (!work.claim(shard, worker)) continue;
+            if (work.isDone(shard)) {
+                // Finished between the check and the claim
+                work.reissue(shard);
+                continue;
+            }
+            claimed = true;
+            hold(shard);
+            
+            UsernameReader reader(work.shardPath(shard));
+            ResultStore results(platforms);
+            size_t checked = 0;
+            bool ok = reader.isOpen() && checker.searchStream(
+                [&](std::string& name) { return reader.next(name); },
+                [&](UserSearch& search) {
+                    checked++;
+                    storeResult(results, search);
+                    if (verbose) printBatchResult(search);
+                });
+            hold(SIZE_MAX);
+            
+            std::string temp = work.resultTempPath(shard, worker);
+            if (!ok || !results.save(temp) || !work.finish(shard, temp)) {
+                std::cerr << RED_COLOR << "Error: Could not complete shard " << shard << RESET_COLOR << std::endl;
+                std::remove(temp.c_str());
+                work.reissue(shard);
+                leave();
+                return 1;
+            }
+            processed++;
+            usernames += checked;
+            std::cout << GREEN_COLOR << "✓ Shard " << shard << ": " << checked << " username(s)" << RESET_COLOR << std::endl;
+        }
+        if (!pending) break;
+        if (!claimed) {
+            // Everything left is leased; wait for it to finish or be re-issued
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+    leave();
+    
+    std::cout << BLUE_COLOR << "\n⏱️  Worker checked " << usernames << " username(s) in " << processed << " shard(s)"
+              << RESET_COLOR << std::endl;
+    printRunStats(checker, services, verbose, options.timeout);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    EngineOptions options;
+    bool prefetch = false;
+    std::string username;
+    bool exportJSON = false;
+    std::string outputFile = "";
+    std::string batchFile = "";
+    std::string platformsFile = "";
+    std::string ndjsonFile = "";
+    std::string cacheDir = "";
+    long maxAge = 24 * 60 * 60;
+    bool refresh = false;
+    int breakerThreshold = 3;
+    long breakerCooldown = 600;
+    double timeoutFactor = 3.0;
+    double deadline = 0;
+    std::string socketPath = "";
+    std::string resultsFile = "";
+    std::string convertFile = "";
+    std::string journalDir = "";
+    std::string resumeDir = "";
+    std::string coordinateDir = "";
+    std::string workDir = "";
+    CoordinatorOptions coordinator;
+    bool variants = false;
+    VariantRules variantRules;
+    bool showStats = false;
+    std::string metricsFile = "";
+    
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "-h" || arg == "--help") {
+            printBanner();
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-v" || arg == "--verbose") {
+            verbose = true;
+        } else if (arg == "-t" || arg == "--timeout") {
+            if (i + 1 < argc) {
+                options.timeout = std::atoi(argv[++i]);
+                if (options.timeout <= 0) {
+                    std::cerr << RED_COLOR << "Error: Timeout must be a positive integer" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --timeout requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "-c" || arg == "--concurrency") {
+            if (i + 1 < argc) {
+                options.concurrency = std::atoi(argv[++i]);
+                if (options.concurrency <= 0) {
+                    std::cerr << RED_COLOR << "Error: Concurrency must be a positive integer" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --concurrency requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--rate" || arg == "--burst") {
+            if (i + 1 < argc) {
+                double value = std::atof(argv[++i]);
+                if (value <= 0) {
+                    std::cerr << RED_COLOR << "Error: " << arg << " must be a positive number" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+                (arg == "--rate" ? options.hostRate : options.hostBurst) = value;
+            } else {
+                std::cerr << RED_COLOR << "Error: " << arg << " requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "-b" || arg == "--batch") {
+            if (i + 1 < argc) {
+                batchFile = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --batch requires a filename (or - for stdin)" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--platforms") {
+            if (i + 1 < argc) {
+                platformsFile = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --platforms requires a filename" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--dump-platforms") {
+            std::cout << DEFAULT_PLATFORM_DB;
+            return 0;
+        } else if (arg == "--max-body") {
+            if (i + 1 < argc) {
+                long long bytes = std::atoll(argv[++i]);
+                if (bytes <= 0) {
+                    std::cerr << RED_COLOR << "Error: --max-body must be a positive number of bytes" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+                options.maxBody = (size_t)bytes;
+            } else {
+                std::cerr << RED_COLOR << "Error: --max-body requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--http1") {
+            options.http2 = false;
+        } else if (arg == "--max-streams") {
+            if (i + 1 < argc) {
+                options.maxStreams = std::atol(argv[++i]);
+                if (options.maxStreams <= 0) {
+                    std::cerr << RED_COLOR << "Error: --max-streams must be a positive integer" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --max-streams requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--connect-to") {
+            if (i + 1 < argc) {
+                options.connectTo.push_back(argv[++i]);
+            } else {
+                std::cerr << RED_COLOR << "Error: --connect-to requires HOST:PORT:ADDR:PORT" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--prefetch") {
+            prefetch = true;
+        } else if (arg == "-j" || arg == "--json") {
+            exportJSON = true;
+        } else if (arg == "--ndjson") {
+            if (i + 1 < argc) {
+                ndjsonFile = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --ndjson requires a filename" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--cache-dir") {
+            if (i + 1 < argc) {
+                cacheDir = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --cache-dir requires a directory" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--max-age") {
+            if (i + 1 < argc) {
+                maxAge = std::atol(argv[++i]);
+                if (maxAge < 0) {
+                    std::cerr << RED_COLOR << "Error: --max-age must not be negative" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --max-age requires a value in seconds" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--refresh") {
+            refresh = true;
+        } else if (arg == "--breaker-threshold") {
+            if (i + 1 < argc) {
+                breakerThreshold = std::atoi(argv[++i]);
+                if (breakerThreshold < 0) {
+                    std::cerr << RED_COLOR << "Error: --breaker-threshold must not be negative" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --breaker-threshold requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--breaker-cooldown") {
+            if (i + 1 < argc) {
+                breakerCooldown = std::atol(argv[++i]);
+                if (breakerCooldown < 0) {
+                    std::cerr << RED_COLOR << "Error: --breaker-cooldown must not be negative" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --breaker-cooldown requires a value in seconds" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--timeout-factor") {
+            if (i + 1 < argc) {
+                timeoutFactor = std::atof(argv[++i]);
+                if (timeoutFactor < 0) {
+                    std::cerr << RED_COLOR << "Error: --timeout-factor must not be negative" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --timeout-factor requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--results") {
+            if (i + 1 < argc) {
+                resultsFile = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --results requires a filename" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--convert") {
+            if (i + 1 < argc) {
+                convertFile = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --convert requires a filename" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--coordinate" || arg == "--work") {
+            if (i + 1 < argc) {
+                (arg == "--work" ? workDir : coordinateDir) = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: " << arg << " requires a directory" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--shard-size" || arg == "--workers" || arg == "--lease-timeout") {
+            if (i + 1 < argc) {
+                long value = std::atol(argv[++i]);
+                if (value <= 0) {
+                    std::cerr << RED_COLOR << "Error: " << arg << " must be a positive integer" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+                if (arg == "--shard-size") coordinator.shardSize = value;
+                else if (arg == "--workers") coordinator.workers = (int)value;
+                else coordinator.leaseTimeout = value;
+            } else {
+                std::cerr << RED_COLOR << "Error: " << arg << " requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--journal" || arg == "--resume") {
+            if (i + 1 < argc) {
+                (arg == "--journal" ? journalDir : resumeDir) = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: " << arg << " requires a directory" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--variants") {
+            variants = true;
+        } else if (arg == "--variant-rules") {
+            if (i + 1 < argc) {
+                std::string error;
+                if (!variantRules.parse(argv[++i], error)) {
+                    std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+                    return 1;
+                }
+                variants = true;
+            } else {
+                std::cerr << RED_COLOR << "Error: --variant-rules requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--serve") {
+            if (i + 1 < argc) {
+                socketPath = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --serve requires a socket path" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--deadline") {
+            if (i + 1 < argc) {
+                deadline = std::atof(argv[++i]);
+                if (deadline <= 0) {
+                    std::cerr << RED_COLOR << "Error: --deadline must be a positive number of seconds" << RESET_COLOR << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << RED_COLOR << "Error: --deadline requires a value" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "--hedge") {
+            options.hedge = true;
+        } else if (arg == "--stats") {
+            showStats = true;
+        } else if (arg == "--metrics") {
+            if (i + 1 < argc) {
+                metricsFile = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --metrics requires a filename" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg == "-o" || arg == "--output") {
+            if (i + 1 < argc) {
+                outputFile = argv[++i];
+            } else {
+                std::cerr << RED_COLOR << "Error: --output requires a filename" << RESET_COLOR << std::endl;
+                return 1;
+            }
+        } else if (arg[0] != '-') {
+            username = arg;
+        } else {
+            std::cerr << RED_COLOR << "Error: Unknown option " << arg << RESET_COLOR << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (!journalDir.empty() || !resumeDir.empty()) {
+        if (!username.empty() || !socketPath.empty() || !convertFile.empty() || !coordinateDir.empty() || !workDir.empty() ||
+            variants || deadline > 0) {
+            std::cerr << RED_COLOR << "Error: --journal and --resume only apply to --batch runs without --deadline or --variants"
+                      << RESET_COLOR << std::endl;
+            return 1;
+        }
+        if (!journalDir.empty() && !resumeDir.empty()) {
+            std::cerr << RED_COLOR << "Error: --resume continues the journal it names; drop --journal" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        if (!journalDir.empty() && batchFile.empty()) {
+            std::cerr << RED_COLOR << "Error: --journal needs --batch" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        if (!journalDir.empty() && batchFile == "-") {
+            std::cerr << RED_COLOR << "Error: --journal needs a batch file, not stdin" << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    // The journal names the batch and platform database of the run it resumes
+    if (!resumeDir.empty()) {
+        if (!batchFile.empty() || !platformsFile.empty()) {
+            std::cerr << RED_COLOR << "Error: --resume takes the batch file and platforms from the journal" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        std::string error;
+        if (!RunJournal::readRun(resumeDir, batchFile, platformsFile, error)) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    
+    // Show banner
+    printBanner();
+    
+    PlatformTable platforms = PlatformTable::builtin();
+    if (!platformsFile.empty()) {
+        std::string error;
+        if (!platforms.loadFile(platformsFile, error)) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    
+    if (!coordinateDir.empty() || !workDir.empty()) {
+        if (!coordinateDir.empty() && !workDir.empty()) {
+            std::cerr << RED_COLOR << "Error: --coordinate and --work are separate processes" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        if (!username.empty() || !socketPath.empty() || !convertFile.empty() || deadline > 0 || variants) {
+            std::cerr << RED_COLOR << "Error: --coordinate and --work cannot be combined with a username, --serve, --convert, --deadline or --variants"
+                      << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    if (!workDir.empty() && (!batchFile.empty() || exportJSON || !outputFile.empty() || !resultsFile.empty())) {
+        std::cerr << RED_COLOR << "Error: --batch, --json, --output and --results belong to the --coordinate process"
+                  << RESET_COLOR << std::endl;
+        return 1;
+    }
+    if (!coordinateDir.empty()) {
+        std::string database = DEFAULT_PLATFORM_DB;
+        if (!platformsFile.empty()) {
+            std::ifstream file(platformsFile, std::ios::binary);
+            database.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        return runCoordinator(coordinateDir, batchFile, coordinator, options, database, exportJSON, outputFile, resultsFile);
+    }
+    
+    if (!convertFile.empty()) {
+        if (!username.empty() || !batchFile.empty() || !socketPath.empty()) {
+            std::cerr << RED_COLOR << "Error: --convert cannot be combined with a username, --batch or --serve" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        return runConvert(convertFile, exportJSON, outputFile);
+    }
+    
+    NDJSONSink sink;
+    if (!ndjsonFile.empty() && !sink.open(ndjsonFile)) {
+        std::cerr << RED_COLOR << "Error: Could not create NDJSON file " << ndjsonFile << RESET_COLOR << std::endl;
+        return 1;
+    }
+    
+    ResultCache cache;
+    if (!cacheDir.empty()) {
+        std::string error;
+        if (!cache.open(cacheDir, error)) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    
+    // Breaker state lives next to the result cache so it carries across runs
+    HostHealth health(breakerThreshold, breakerCooldown);
+    std::string healthFile = cacheDir.empty() || breakerThreshold == 0 ? "" : cacheDir + "/health.tsv";
+    if (!healthFile.empty()) {
+        std::string error;
+        if (!health.load(healthFile, error)) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    
+    // Latency history is kept in-run, and across runs with --cache-dir
+    LatencyTracker latency(timeoutFactor);
+    std::string latencyFile = cacheDir.empty() ? "" : cacheDir + "/latency.tsv";
+    if (!latencyFile.empty()) {
+        std::string error;
+        if (!latency.load(latencyFile, error)) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    
+    // Per-platform hit rates decide the check order; kept like the latency history
+    PlatformHistory history;
+    std::string historyFile = cacheDir.empty() ? "" : cacheDir + "/history.tsv";
+    if (!historyFile.empty()) {
+        std::string error;
+        if (!history.load(historyFile, error)) {
+            std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+            return 1;
+        }
+    }
+    
+    RunMetrics metrics;
+    
+    RunServices services;
+    services.sink = sink.isOpen() ? &sink : nullptr;
+    services.cache = cache.isOpen() ? &cache : nullptr;
+    services.maxAge = maxAge;
+    services.refresh = refresh;
+    services.health = breakerThreshold > 0 ? &health : nullptr;
+    services.latency = &latency;
+    services.metrics = showStats || !metricsFile.empty() ? &metrics : nullptr;
+    services.showStats = showStats;
+    services.metricsFile = metricsFile;
+    services.history = &history;
+    services.deadline = deadline;
+    
+    // Results are kept compactly for the whole run only when asked for
+    ResultStore results(platforms);
+    services.results = resultsFile.empty() ? nullptr : &results;
+    
+    // Health, latency and hit history outlive the run when there is a cache dir
+    auto saveState = [&]() {
+        if (!healthFile.empty() && !health.save(healthFile)) {
+            std::cerr << RED_COLOR << "Error: Could not write " << healthFile << RESET_COLOR << std::endl;
+        }
+        if (!latencyFile.empty() && !latency.save(latencyFile)) {
+            std::cerr << RED_COLOR << "Error: Could not write " << latencyFile << RESET_COLOR << std::endl;
+        }
+        if (!historyFile.empty() && !history.save(historyFile)) {
+            std::cerr << RED_COLOR << "Error: Could not write " << historyFile << RESET_COLOR << std::endl;
+        }
+    };
+    
+    if (!workDir.empty()) {
+        int status = runWorker(workDir, verbose, options, prefetch, services);
+        saveState();
+        return status;
+    }
+    
+    if (!socketPath.empty()) {
+        if (!username.empty() || !batchFile.empty() || exportJSON || !outputFile.empty() || deadline > 0 || !resultsFile.empty() ||
+            variants) {
+            std::cerr << RED_COLOR << "Error: --serve cannot be combined with a username, --batch, --json, --output, --deadline, --results or --variants"
+                      << RESET_COLOR << std::endl;
+            return 1;
+        }
+        int status = runServe(socketPath, verbose, options, platforms, prefetch, services, saveState);
+        saveState();
+        return status;
+    }
+    
+    if (variants) {
+        if (!username.empty() == !batchFile.empty()) {
+            std::cerr << RED_COLOR << "Error: --variants needs either a username or --batch" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        UsernameReader reader(batchFile.empty() ? "" : batchFile);
+        if (!batchFile.empty() && !reader.isOpen()) {
+            std::cerr << RED_COLOR << "Error: Could not open batch file " << batchFile << RESET_COLOR << std::endl;
+            return 1;
+        }
+        bool pending = !username.empty();
+        auto nextIdentity = [&](std::string& identity) {
+            if (!pending) return reader.next(identity);
+            identity = username;
+            pending = false;
+            return true;
+        };
+        int status = runVariants(nextIdentity, variantRules, verbose, options, platforms, prefetch, exportJSON, outputFile, services);
+        saveState();
+        if (services.results) {
+            saveResults(results, resultsFile);
+        }
+        return status;
+    }
+    
+    if (!batchFile.empty()) {
+        if (!username.empty()) {
+            std::cerr << RED_COLOR << "Error: --batch cannot be combined with a username argument" << RESET_COLOR << std::endl;
+            return 1;
+        }
+        RunJournal journal;
+        if (!journalDir.empty() || !resumeDir.empty()) {
+            std::string error;
+            bool opened = journalDir.empty() ? journal.resume(resumeDir, platforms, error)
+                                             : journal.create(journalDir, batchFile, platformsFile, platforms, error);
+            if (!opened) {
+                std::cerr << RED_COLOR << "Error: " << error << RESET_COLOR << std::endl;
+                return 1;
+            }
+            services.journal = &journal;
+        }
+        int status = runBatch(batchFile, verbose, options, platforms, prefetch, exportJSON, outputFile, services);
+        saveState();
+        if (services.results) {
+            saveResults(results, resultsFile);
+        }
+        return status;
+    }
+    
+    // Check if username is provided
+    if (username.empty()) {
+        std::cerr << RED_COLOR << "Error: Username is required!" << RESET_COLOR << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    // Validate username
+    if (!isValidUsername(username)) {
+        std::cerr << RED_COLOR << "Error: Username must be between 2 and 50 characters!" << RESET_COLOR << std::endl;
+        return 1;
+    }
+    
+    // Create OSINT checker instance
+    OSINTChecker checker(verbose, options, platforms);
+    attachServices(checker, services);
+    
+    // Start search
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (prefetch) {
+        checker.prefetch();
+    }
+    UserSearch search = checker.searchUsername(username);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    // Calculate duration
+    auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    
+    // Print results
+    printResults(search.found);
+    if (search.unchecked) {
+        printIncomplete(search.unchecked, checker.platformCount());
+    }
+    if (services.results) {
+        storeResult(*services.results, search);
+    }
+    
+    // Export results if requested
+    if (exportJSON) {
+        exportToJSON(search.found, username, search.unchecked);
+    }
+    
+    if (!outputFile.empty()) {
+        exportToTXT(search.found, username, outputFile, false, search.unchecked);
+    }
+    
+    std::cout << BLUE_COLOR << "⏱️  Search completed in " << duration.count() << " seconds" << RESET_COLOR << std::endl;
+    printRunStats(checker, services, verbose, options.timeout);
+    saveState();
+    if (services.results) {
+        saveResults(results, resultsFile);
+    }
     std::cout << YELLOW_COLOR << "⚠️  Remember: This tool is for educational and legitimate research purposes only!" << RESET_COLOR << std::endl;
     
     return 0;
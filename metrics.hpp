@@ -0,0 +1,126 @@
+#pragma once
+#include <string>
+#include <map>
+#include <cstdio>
+#include <fstream>
+#include "check_job.hpp"
+#include "latency.hpp"
+
+// Request phases tracked by RunMetrics, in the order they happen
+enum Phase { PHASE_DNS, PHASE_CONNECT, PHASE_TLS, PHASE_TTFB, PHASE_TOTAL, PHASE_COUNT };
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {"dns", "connect", "tls", "ttfb", "total"};
+
+// Timing histograms and counters for one host (or the whole run)
+struct PhaseStats {
+    LatencyHistogram histograms[PHASE_COUNT];
+    double sums[PHASE_COUNT] = {};
+    size_t counts[PHASE_COUNT] = {};
+    size_t requests = 0;
+    size_t errors = 0;
+    long long bytes = 0;
+    std::map<std::string, size_t> statuses;   // "2xx" ... "5xx", "error"
+
+    void add(const CheckOutcome& outcome) {
+        const TransferTiming& timing = outcome.timing;
+        double phases[PHASE_COUNT] = {timing.dns, timing.connect, timing.tls, timing.ttfb, outcome.seconds};
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            // A phase that did not happen (reused connection, plain HTTP) is not a 0 ms sample
+            if (phases[phase] <= 0 && phase != PHASE_TOTAL) continue;
+            histograms[phase].add(phases[phase]);
+            sums[phase] += phases[phase];
+            counts[phase]++;
+        }
+
+        requests++;
+        bytes += timing.bytes;
+        if (outcome.error != CURLE_OK || outcome.responseCode < 100) {
+            errors++;
+            statuses["error"]++;
+        } else {
+            statuses[std::to_string(outcome.responseCode / 100) + "xx"]++;
+        }
+    }
+};
+
+// Per-host and run-wide request metrics for --stats and --metrics.
+// Only requests that actually went out are recorded; cached, skipped and
+// cancelled checks have no timing.
+class RunMetrics {
+private:
+    PhaseStats overall;
+    std::map<std::string, PhaseStats> perHost;
+
+    static std::string label(const std::string& value) {
+        std::string out;
+        for (char c : value) {
+            if (c == '\\' || c == '"') out += '\\';
+            if (c == '\n') {
+                out += "\\n";
+                continue;
+            }
+            out += c;
+        }
+        return out;
+    }
+
+    static void writeSummary(std::ofstream& file, const std::string& name, const std::string& labels, const PhaseStats& stats) {
+        static const double quantiles[] = {0.5, 0.95, 0.99};
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            if (stats.counts[phase] == 0) continue;
+            std::string series = labels + "phase=\"" + PHASE_NAMES[phase] + "\"";
+            for (double q : quantiles) {
+                file << name << "{" << series << ",quantile=\"" << q << "\"} " << stats.histograms[phase].percentile(q) << "\n";
+            }
+            file << name << "_sum{" << series << "} " << stats.sums[phase] << "\n";
+            file << name << "_count{" << series << "} " << stats.counts[phase] << "\n";
+        }
+    }
+
+public:
+    void record(const CheckOutcome& outcome) {
+        if (outcome.cached || outcome.skipped || outcome.cancelled) return;
+        overall.add(outcome);
+        perHost[outcome.job.host].add(outcome);
+    }
+
+    const PhaseStats& total() const { return overall; }
+    const std::map<std::string, PhaseStats>& hosts() const { return perHost; }
+
+    // Prometheus text exposition format, e.g. for node_exporter's textfile
+    // collector. The file is replaced atomically.
+    bool writePrometheus(const std::string& path) const {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            if (!file.is_open()) return false;
+
+            file << "# HELP yougoldberg_run_phase_seconds Time spent in each request phase across all hosts.\n";
+            file << "# TYPE yougoldberg_run_phase_seconds summary\n";
+            writeSummary(file, "yougoldberg_run_phase_seconds", "", overall);
+
+            file << "# HELP yougoldberg_phase_seconds Time spent in each request phase per host.\n";
+            file << "# TYPE yougoldberg_phase_seconds summary\n";
+            for (const auto& entry : perHost) {
+                writeSummary(file, "yougoldberg_phase_seconds", "host=\"" + label(entry.first) + "\",", entry.second);
+            }
+
+            file << "# HELP yougoldberg_requests_total Requests sent, by host and status class.\n";
+            file << "# TYPE yougoldberg_requests_total counter\n";
+            for (const auto& entry : perHost) {
+                for (const auto& status : entry.second.statuses) {
+                    file << "yougoldberg_requests_total{host=\"" << label(entry.first) << "\",status=\"" << status.first << "\"} "
+                         << status.second << "\n";
+                }
+            }
+
+            file << "# HELP yougoldberg_received_bytes_total Response bytes received, headers included.\n";
+            file << "# TYPE yougoldberg_received_bytes_total counter\n";
+            for (const auto& entry : perHost) {
+                file << "yougoldberg_received_bytes_total{host=\"" << label(entry.first) << "\"} " << entry.second.bytes << "\n";
+            }
+            if (!file) return false;
+        }
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+};
@@ -1,109 +1,407 @@
 #pragma once
-#include <map>
 #include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "scheduler.hpp"
+#include "detect.hpp"
+#include "hash.hpp"
 
-std::map<std::string, std::string> getPlatforms() {
-    return {
-        {"GitHub", "https://github.com/%s"},
-        {"GitLab", "https://gitlab.com/%s"},
-        {"Twitter", "https://twitter.com/%s"},
-        {"Reddit", "https://www.reddit.com/user/%s"},
-        {"Facebook", "https://www.facebook.com/%s"},
-        {"Instagram", "https://www.instagram.com/%s"},
-        {"LinkedIn", "https://www.linkedin.com/in/%s"},
-        {"YouTube", "https://www.youtube.com/@%s"},
-        {"Twitch", "https://www.twitch.tv/%s"},
-        {"TikTok", "https://www.tiktok.com/@%s"},
-        {"Pinterest", "https://www.pinterest.com/%s"},
-        {"Snapchat", "https://www.snapchat.com/add/%s"},
-        {"Vimeo", "https://vimeo.com/%s"},
-        {"SoundCloud", "https://soundcloud.com/%s"},
-        {"Flickr", "https://www.flickr.com/people/%s"},
-        {"Behance", "https://www.behance.net/%s"},
-        {"Dribbble", "https://dribbble.com/%s"},
-        {"DeviantArt", "https://www.deviantart.com/%s"},
-        {"ProductHunt", "https://www.producthunt.com/@%s"},
-        {"Medium", "https://medium.com/@%s"},
-        {"StackOverflow", "https://stackoverflow.com/users/%s"},
-        {"StackExchange", "https://stackexchange.com/users/%s"},
-        {"Replit", "https://replit.com/@%s"},
-        {"Dev.to", "https://dev.to/%s"},
-        {"Codepen", "https://codepen.io/%s"},
-        {"Hackaday", "https://hackaday.io/%s"},
-        {"FreeCodeCamp", "https://www.freecodecamp.org/%s"},
-        {"Codementor", "https://www.codementor.io/%s"},
-        {"Gitee", "https://gitee.com/%s"},
-        {"SourceForge", "https://sourceforge.net/u/%s"},
-        {"Blogger", "https://%s.blogspot.com"},
-        {"WordPress", "https://%s.wordpress.com"},
-        {"Tumblr", "https://%s.tumblr.com"},
-        {"Wattpad", "https://www.wattpad.com/user/%s"},
-        {"Quora", "https://www.quora.com/profile/%s"},
-        {"Goodreads", "https://www.goodreads.com/user/show/%s"},
-        {"Vox", "https://www.vox.com/users/%s"},
-        {"Notion", "https://www.notion.so/%s"},
-        {"Ghost", "https://%s.ghost.io"},
-        {"Hashnode", "https://hashnode.com/@%s"},
-        {"Pastebin", "https://pastebin.com/u/%s"},
-        {"Keybase", "https://keybase.io/%s"},
-        {"Gravatar", "https://en.gravatar.com/%s"},
-        {"ExploitDB", "https://www.exploit-db.com/author/%s"},
-        {"HackerOne", "https://hackerone.com/%s"},
-        {"Bugcrowd", "https://bugcrowd.com/%s"},
-        {"Censys", "https://search.censys.io/profile/%s"},
-        {"TryHackMe", "https://tryhackme.com/p/%s"},
-        {"HackTheBox", "https://app.hackthebox.com/profile/%s"},
-        {"SecurityTrails", "https://securitytrails.com/users/%s"},
-        {"500px", "https://500px.com/%s"},
-        {"Imgur", "https://imgur.com/user/%s"},
-        {"Canva", "https://www.canva.com/%s"},
-        {"Crevado", "https://%s.crevado.com"},
-        {"Carbonmade", "https://%s.carbonmade.com"},
-        {"ArtStation", "https://www.artstation.com/%s"},
-        {"Ello", "https://ello.co/%s"},
-        {"Zazzle", "https://www.zazzle.com/%s"},
-        {"ViewBug", "https://www.viewbug.com/member/%s"},
-        {"Designspiration", "https://www.designspiration.com/%s"},
-        {"Disqus", "https://disqus.com/by/%s"},
-        {"Slack", "https://%s.slack.com"},
-        {"Trello", "https://trello.com/%s"},
-        {"XDA Developers", "https://forum.xda-developers.com/m/%s"},
-        {"Kaggle", "https://www.kaggle.com/%s"},
-        {"ResearchGate", "https://www.researchgate.net/profile/%s"},
-        {"MyAnimeList", "https://myanimelist.net/profile/%s"},
-        {"Steam", "https://steamcommunity.com/id/%s"},
-        {"Roblox", "https://www.roblox.com/user.aspx?username=%s"},
-        {"Scratch", "https://scratch.mit.edu/users/%s"},
-        {"Flipboard", "https://flipboard.com/@%s"},
-        {"WeHeartIt", "https://weheartit.com/%s"},
-        {"Bluesky", "https://bsky.app/profile/%s.bsky.social"},
-        {"AminoApps", "https://aminoapps.com/u/%s"},
-        {"Letterboxd", "https://letterboxd.com/%s"},
-        {"Dailymotion", "https://www.dailymotion.com/%s"},
-        {"Furaffinity", "https://www.furaffinity.net/user/%s"},
-        {"OpenSea", "https://opensea.io/%s"},
-        {"NameMC", "https://namemc.com/profile/%s"},
-        {"Chess.com", "https://www.chess.com/member/%s"},
-        {"Lemmy", "https://lemmy.world/u/%s"},
-        {"Misskey", "https://misskey.io/@%s"},
-        {"PeerTube", "https://%s.video"}, // platform-specific, dynamic
-        {"Mastodon", "https://mastodon.social/@%s"},
-        {"Lichess", "https://lichess.org/@/%s"},
-        {"Gogs", "https://try.gogs.io/%s"},
-        {"Ko-fi", "https://ko-fi.com/%s"},
-        {"BuyMeACoffee", "https://www.buymeacoffee.com/%s"},
-        {"Patreon", "https://www.patreon.com/%s"},
-        {"CashApp", "https://cash.app/%s"},
-        {"PayPal.Me", "https://www.paypal.me/%s"},
-        {"Producteev", "https://www.producteev.com/%s"},
-        {"Bitbucket", "https://bitbucket.org/%s"},
-        {"Launchpad", "https://launchpad.net/~%s"},
-        {"Myspace", "https://myspace.com/%s"},
-        {"OK.ru", "https://ok.ru/%s"},
-        {"VK", "https://vk.com/%s"},
-        {"Mixcloud", "https://www.mixcloud.com/%s"},
-        {"Bandcamp", "https://%s.bandcamp.com"},
-        {"Etsy", "https://www.etsy.com/shop/%s"},
-        {"Codeberg", "https://codeberg.org/%s"},
-    };
-} 
\ No newline at end of file
+// Version of the platform database format understood by this build
+#define PLATFORM_DB_VERSION 1
+
+// Compiled-in default database; identical in format to platforms.tsv
+static const char DEFAULT_PLATFORM_DB[] = R"DB(yougoldberg-platforms	1
+# YouGoldberg platform database
+#
+# One platform per line: NAME<TAB>URL-TEMPLATE[<TAB>key=value...]
+# The template must contain exactly one %s, which is replaced by the
+# username; any other % is taken literally. Optional attributes:
+#   enabled=0           keep the entry but skip it when searching
+#   status=200,301      statuses that count as found (default: 200)
+#   notfound-url=TEXT   not found when the final URL (after redirects) contains TEXT
+#   found=TEXT          found only if the body contains TEXT
+#   notfound=TEXT       not found if the body contains TEXT
+#   ttl=SECONDS         how long a cached result stays fresh (default: --max-age)
+# Username rules, used by --variants to skip names a site cannot have and
+# to check names the site treats as equal only once:
+#   case=insensitive    the site folds case; names are lowercased
+#   ignore=CHARS        characters the site drops, e.g. ignore=.
+#   chars=RANGES        characters a name may contain, e.g. chars=a-z0-9_
+#   length=MIN-MAX      allowed name length after folding
+# A username in the host name (%s.example.com) is always folded and
+# limited to a DNS label.
+# Rules with found/notfound fetch the body (GET) instead of sending HEAD;
+# the download stops as soon as the verdict is known or --max-body is hit.
+# Lines starting with # are comments. The first line must declare the
+# format version.
+GitHub	https://github.com/%s	case=insensitive	chars=a-z0-9-	length=1-39
+GitLab	https://gitlab.com/%s	case=insensitive	chars=a-z0-9_.-	length=2-255
+Twitter	https://twitter.com/%s	case=insensitive	chars=a-z0-9_	length=1-15
+Reddit	https://www.reddit.com/user/%s	notfound=Sorry, nobody on Reddit goes by that name.	case=insensitive	chars=a-z0-9_-	length=3-20
+Facebook	https://www.facebook.com/%s	case=insensitive	ignore=.	chars=a-z0-9	length=5-50
+Instagram	https://www.instagram.com/%s	case=insensitive	chars=a-z0-9._	length=1-30
+LinkedIn	https://www.linkedin.com/in/%s	case=insensitive
+YouTube	https://www.youtube.com/@%s	case=insensitive	chars=a-z0-9._-	length=3-30
+Twitch	https://www.twitch.tv/%s	case=insensitive	chars=a-z0-9_	length=4-25
+TikTok	https://www.tiktok.com/@%s	case=insensitive	chars=a-z0-9._	length=2-24
+Pinterest	https://www.pinterest.com/%s	case=insensitive	chars=a-z0-9_	length=3-30
+Snapchat	https://www.snapchat.com/add/%s
+Vimeo	https://vimeo.com/%s	case=insensitive
+SoundCloud	https://soundcloud.com/%s	case=insensitive
+Flickr	https://www.flickr.com/people/%s
+Behance	https://www.behance.net/%s	case=insensitive
+Dribbble	https://dribbble.com/%s	case=insensitive
+DeviantArt	https://www.deviantart.com/%s	case=insensitive
+ProductHunt	https://www.producthunt.com/@%s
+Medium	https://medium.com/@%s	case=insensitive
+StackOverflow	https://stackoverflow.com/users/%s
+StackExchange	https://stackexchange.com/users/%s
+Replit	https://replit.com/@%s	case=insensitive
+Dev.to	https://dev.to/%s	case=insensitive
+Codepen	https://codepen.io/%s
+Hackaday	https://hackaday.io/%s
+FreeCodeCamp	https://www.freecodecamp.org/%s
+Codementor	https://www.codementor.io/%s
+Gitee	https://gitee.com/%s
+SourceForge	https://sourceforge.net/u/%s
+Blogger	https://%s.blogspot.com
+WordPress	https://%s.wordpress.com	notfound-url=wordpress.com/typo
+Tumblr	https://%s.tumblr.com
+Wattpad	https://www.wattpad.com/user/%s
+Quora	https://www.quora.com/profile/%s
+Goodreads	https://www.goodreads.com/user/show/%s
+Vox	https://www.vox.com/users/%s
+Notion	https://www.notion.so/%s
+Ghost	https://%s.ghost.io
+Hashnode	https://hashnode.com/@%s
+Pastebin	https://pastebin.com/u/%s
+Keybase	https://keybase.io/%s	case=insensitive	chars=a-z0-9_	length=2-16
+Gravatar	https://en.gravatar.com/%s	case=insensitive
+ExploitDB	https://www.exploit-db.com/author/%s
+HackerOne	https://hackerone.com/%s	case=insensitive
+Bugcrowd	https://bugcrowd.com/%s
+Censys	https://search.censys.io/profile/%s
+TryHackMe	https://tryhackme.com/p/%s
+HackTheBox	https://app.hackthebox.com/profile/%s
+SecurityTrails	https://securitytrails.com/users/%s
+500px	https://500px.com/%s
+Imgur	https://imgur.com/user/%s	case=insensitive
+Canva	https://www.canva.com/%s
+Crevado	https://%s.crevado.com
+Carbonmade	https://%s.carbonmade.com
+ArtStation	https://www.artstation.com/%s
+Ello	https://ello.co/%s
+Zazzle	https://www.zazzle.com/%s
+ViewBug	https://www.viewbug.com/member/%s
+Designspiration	https://www.designspiration.com/%s
+Disqus	https://disqus.com/by/%s
+Slack	https://%s.slack.com	notfound-url=://slack.com/
+Trello	https://trello.com/%s	case=insensitive
+XDA Developers	https://forum.xda-developers.com/m/%s
+Kaggle	https://www.kaggle.com/%s	case=insensitive
+ResearchGate	https://www.researchgate.net/profile/%s
+MyAnimeList	https://myanimelist.net/profile/%s
+Steam	https://steamcommunity.com/id/%s	notfound=The specified profile could not be found	case=insensitive
+Roblox	https://www.roblox.com/user.aspx?username=%s	case=insensitive
+Scratch	https://scratch.mit.edu/users/%s	case=insensitive
+Flipboard	https://flipboard.com/@%s
+WeHeartIt	https://weheartit.com/%s
+Bluesky	https://bsky.app/profile/%s.bsky.social	case=insensitive	chars=a-z0-9-	length=3-18
+AminoApps	https://aminoapps.com/u/%s
+Letterboxd	https://letterboxd.com/%s	case=insensitive
+Dailymotion	https://www.dailymotion.com/%s
+Furaffinity	https://www.furaffinity.net/user/%s
+OpenSea	https://opensea.io/%s
+NameMC	https://namemc.com/profile/%s
+Chess.com	https://www.chess.com/member/%s	case=insensitive	chars=a-z0-9_-	length=3-25
+Lemmy	https://lemmy.world/u/%s	case=insensitive
+Misskey	https://misskey.io/@%s	case=insensitive
+# PeerTube: platform-specific, dynamic
+PeerTube	https://%s.video
+Mastodon	https://mastodon.social/@%s	case=insensitive
+Lichess	https://lichess.org/@/%s	case=insensitive	chars=a-z0-9_-	length=2-30
+Gogs	https://try.gogs.io/%s
+Ko-fi	https://ko-fi.com/%s	case=insensitive
+BuyMeACoffee	https://www.buymeacoffee.com/%s
+Patreon	https://www.patreon.com/%s	case=insensitive
+CashApp	https://cash.app/%s
+PayPal.Me	https://www.paypal.me/%s
+Producteev	https://www.producteev.com/%s
+Bitbucket	https://bitbucket.org/%s	case=insensitive
+Launchpad	https://launchpad.net/~%s
+Myspace	https://myspace.com/%s
+OK.ru	https://ok.ru/%s
+VK	https://vk.com/%s
+Mixcloud	https://www.mixcloud.com/%s
+Bandcamp	https://%s.bandcamp.com
+Etsy	https://www.etsy.com/shop/%s
+Codeberg	https://codeberg.org/%s	case=insensitive	chars=a-z0-9_.-	length=1-40
+)DB";
+
+// A platform whose URL template has been split around the username
+// placeholder, so building a URL is a plain append.
+struct Platform {
+    std::string name;
+    std::string prefix;   // URL text before the username
+    std::string suffix;   // URL text after the username
+    std::string host;     // politeness key, see hostKey()
+    bool enabled = true;
+    long ttl = -1;        // result cache lifetime in seconds, -1 for the global --max-age
+    DetectRule rule;
+    uint64_t revision = 0;     // hash of the URL template and detection rule
+    bool foldCase = false;     // the site treats names case-insensitively
+    std::string ignored;       // characters the site drops from names
+    std::string allowed;       // characters a name may contain, empty for any
+    size_t minLength = 0;
+    size_t maxLength = 0;      // 0 for no limit
+
+    void buildURL(const std::string& username, std::string& out) const {
+        out.clear();
+        out.reserve(prefix.size() + username.size() + suffix.size());
+        out.append(prefix).append(username).append(suffix);
+    }
+
+    std::string urlTemplate() const { return prefix + "%s" + suffix; }
+
+    // The name the site would resolve `username` to, in `out`; false when
+    // the site cannot have such a name
+    bool normalize(const std::string& username, std::string& out) const {
+        out.clear();
+        for (char c : username) {
+            if (ignored.find(c) != std::string::npos) continue;
+            out += foldCase ? (char)tolower((unsigned char)c) : c;
+        }
+        if (out.size() < minLength || (maxLength > 0 && out.size() > maxLength)) return false;
+        return allowed.empty() || out.find_first_not_of(allowed) == std::string::npos;
+    }
+};
+
+// The platform list, loaded from the compiled-in default or from a data file.
+// Entries are kept sorted by name; disabled entries are dropped at load time.
+class PlatformTable {
+private:
+    std::vector<Platform> platforms;
+    std::string source;
+
+    // "a-z0-9_" -> every character it names; a '-' first or last is literal
+    static std::string expandRanges(const std::string& ranges) {
+        std::string chars;
+        for (size_t i = 0; i < ranges.size(); i++) {
+            if (i + 2 < ranges.size() && ranges[i + 1] == '-') {
+                for (int c = (unsigned char)ranges[i]; c <= (unsigned char)ranges[i + 2]; c++) chars += (char)c;
+                i += 2;
+            } else {
+                chars += ranges[i];
+            }
+        }
+        return chars;
+    }
+
+    static bool fail(std::string& error, const std::string& origin, size_t line, const std::string& message) {
+        error = origin + ":" + std::to_string(line) + ": " + message;
+        return false;
+    }
+
+    bool parse(const char* data, size_t size, const std::string& origin, std::string& error) {
+        platforms.clear();
+        source = origin;
+
+        const char* cursor = data;
+        const char* end = data + size;
+        size_t lineNumber = 0;
+        bool sawVersion = false;
+
+        while (cursor < end) {
+            const char* eol = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+            if (!eol) eol = end;
+            std::string line(cursor, eol);
+            cursor = eol + 1;
+            lineNumber++;
+
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+
+            std::vector<std::string> fields;
+            std::stringstream split(line);
+            for (std::string field; std::getline(split, field, '\t');) {
+                fields.push_back(field);
+            }
+
+            if (!sawVersion) {
+                if (fields.size() < 2 || fields[0] != "yougoldberg-platforms") {
+                    return fail(error, origin, lineNumber, "missing 'yougoldberg-platforms<TAB>VERSION' header");
+                }
+                int version = std::atoi(fields[1].c_str());
+                if (version < 1 || version > PLATFORM_DB_VERSION) {
+                    return fail(error, origin, lineNumber, "unsupported database version " + fields[1]);
+                }
+                sawVersion = true;
+                continue;
+            }
+
+            if (fields.size() < 2 || fields[0].empty()) {
+                return fail(error, origin, lineNumber, "expected NAME<TAB>URL-TEMPLATE");
+            }
+
+            const std::string& urlTemplate = fields[1];
+            size_t placeholder = urlTemplate.find("%s");
+            if (placeholder == std::string::npos || urlTemplate.find("%s", placeholder + 2) != std::string::npos) {
+                return fail(error, origin, lineNumber, "template must contain exactly one %s");
+            }
+
+            Platform platform;
+            platform.name = fields[0];
+            platform.prefix = urlTemplate.substr(0, placeholder);
+            platform.suffix = urlTemplate.substr(placeholder + 2);
+            platform.host = hostKey(urlTemplate);
+
+            // A name in the host part is a DNS label
+            size_t scheme = platform.prefix.find("://");
+            if (scheme != std::string::npos && platform.prefix.find('/', scheme + 3) == std::string::npos) {
+                platform.foldCase = true;
+                platform.allowed = expandRanges("a-z0-9-");
+                platform.maxLength = 63;
+            }
+
+            for (size_t i = 2; i < fields.size(); i++) {
+                size_t eq = fields[i].find('=');
+                if (eq == std::string::npos) continue;
+                std::string key = fields[i].substr(0, eq);
+                std::string value = fields[i].substr(eq + 1);
+                if (key == "enabled") {
+                    platform.enabled = (value != "0");
+                } else if (key == "ttl") {
+                    char* end = nullptr;
+                    errno = 0;
+                    platform.ttl = std::strtol(value.c_str(), &end, 10);
+                    if (value.empty() || *end != '\0' || errno != 0 || platform.ttl < 0) {
+                        return fail(error, origin, lineNumber, "ttl must be a non-negative number of seconds, not '" + value + "'");
+                    }
+                } else if (key == "status") {
+                    std::stringstream codes(value);
+                    for (std::string code; std::getline(codes, code, ',');) {
+                        platform.rule.statuses.push_back(std::atol(code.c_str()));
+                    }
+                } else if (key == "notfound-url") {
+                    platform.rule.notFoundURL = value;
+                } else if (key == "found") {
+                    platform.rule.foundMarker = value;
+                } else if (key == "notfound") {
+                    platform.rule.notFoundMarker = value;
+                } else if (key == "case") {
+                    platform.foldCase = (value == "insensitive");
+                } else if (key == "ignore") {
+                    platform.ignored = value;
+                } else if (key == "chars") {
+                    platform.allowed = expandRanges(value);
+                } else if (key == "length") {
+                    size_t dash = value.find('-');
+                    platform.minLength = std::strtoul(value.c_str(), nullptr, 10);
+                    platform.maxLength = dash == std::string::npos ? platform.minLength
+                                                                   : std::strtoul(value.c_str() + dash + 1, nullptr, 10);
+                }
+                // Unknown attributes are ignored so newer files still load
+            }
+
+            std::string definition = urlTemplate + "\n" + platform.rule.notFoundURL + "\n" + platform.rule.foundMarker + "\n" +
+                                     platform.rule.notFoundMarker + "\n";
+            for (long status : platform.rule.statuses) definition += std::to_string(status) + ",";
+            platform.revision = fnv1a64(definition);
+
+            // First definition of a name wins
+            bool duplicate = std::any_of(platforms.begin(), platforms.end(),
+                                         [&](const Platform& p) { return p.name == platform.name; });
+            if (!duplicate) {
+                platforms.push_back(std::move(platform));
+            }
+        }
+
+        if (!sawVersion) {
+            return fail(error, origin, lineNumber, "empty platform database");
+        }
+
+        platforms.erase(std::remove_if(platforms.begin(), platforms.end(),
+                                       [](const Platform& p) { return !p.enabled; }),
+                        platforms.end());
+        std::sort(platforms.begin(), platforms.end(),
+                  [](const Platform& a, const Platform& b) { return a.name < b.name; });
+        return true;
+    }
+
+public:
+    // Table built from the compiled-in default database
+    static PlatformTable builtin() {
+        PlatformTable table;
+        std::string error;
+        table.parse(DEFAULT_PLATFORM_DB, sizeof(DEFAULT_PLATFORM_DB) - 1, "<built-in>", error);
+        return table;
+    }
+
+    // Parse a database held in memory; `origin` names it in error messages
+    bool loadText(const std::string& text, const std::string& origin, std::string& error) {
+        return parse(text.data(), text.size(), origin, error);
+    }
+
+    // Load a database file. The file is memory-mapped where available, so
+    // only the pages actually parsed are ever read.
+    bool loadFile(const std::string& path, std::string& error) {
+#ifndef _WIN32
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "could not open " + path + ": " + strerror(errno);
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            return fail(error, path, 0, "empty platform database");
+        }
+
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            error = "could not map " + path + ": " + strerror(errno);
+            return false;
+        }
+
+        bool ok = parse(static_cast<const char*>(mapped), info.st_size, path, error);
+        munmap(mapped, info.st_size);
+        return ok;
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            error = "could not open " + path;
+            return false;
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return parse(data.data(), data.size(), path, error);
+#endif
+    }
+
+    const std::string& origin() const { return source; }
+    size_t size() const { return platforms.size(); }
+    bool empty() const { return platforms.empty(); }
+    const Platform& operator[](size_t index) const { return platforms[index]; }
+
+    // Platform called `name`, or null
+    const Platform* find(const std::string& name) const {
+        auto found = std::lower_bound(platforms.begin(), platforms.end(), name,
+                                      [](const Platform& p, const std::string& n) { return p.name < n; });
+        return found != platforms.end() && found->name == name ? &*found : nullptr;
+    }
+    std::vector<Platform>::const_iterator begin() const { return platforms.begin(); }
+    std::vector<Platform>::const_iterator end() const { return platforms.end(); }
+};
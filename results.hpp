@@ -0,0 +1,283 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "platforms.hpp"
+
+// Version of the binary result file format understood by this build
+#define RESULT_STORE_VERSION 1
+
+struct ResultFileHeader {
+    char magic[4];          // "YGRS"
+    uint32_t version;
+    uint32_t platforms;
+    uint32_t words;         // 64-bit words per found-bitset
+    uint64_t users;
+    uint64_t hits;
+};
+static_assert(sizeof(ResultFileHeader) == 32, "result file header must stay 32 bytes");
+
+// Columnar results of a run: for every username, a bitset of the platforms
+// it was found on plus one 16-bit HTTP status per hit. Platforms are
+// interned to their index in the table, and URLs are not stored at all
+// since they can be rebuilt from template and username, so a username
+// costs about 40 bytes plus its name and 2 bytes per hit.
+//
+// The binary file is the header followed by the platform table (name and
+// URL template, each NUL-terminated) and then one column after another:
+// username end offsets (u64), usernames, found bitsets (u64 words),
+// hit end offsets (u64), unchecked counts (u16), statuses (u16). Values
+// are stored in host byte order.
+class ResultStore {
+public:
+    struct Hit {
+        uint32_t platform;   // index into the platform table
+        uint16_t status;
+    };
+
+private:
+    std::vector<std::string> platformNames;
+    std::vector<std::string> templates;
+    std::unordered_map<std::string, uint32_t> ids;
+    uint32_t words;
+
+    std::string names;
+    std::vector<uint64_t> nameEnds;
+    std::vector<uint64_t> bits;
+    std::vector<uint64_t> hitEnds;
+    std::vector<uint16_t> unchecked;
+    std::vector<uint16_t> statuses;
+
+    void index() {
+        ids.clear();
+        for (size_t i = 0; i < platformNames.size(); i++) ids[platformNames[i]] = (uint32_t)i;
+        words = (uint32_t)((platformNames.size() + 63) / 64);
+    }
+
+    template <typename T>
+    static void writeColumn(std::ofstream& file, const std::vector<T>& column) {
+        if (!column.empty()) file.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+    }
+
+    template <typename T>
+    static bool readColumn(std::ifstream& file, std::vector<T>& column, uint64_t count) {
+        column.resize(count);
+        if (count == 0) return true;
+        return (bool)file.read(reinterpret_cast<char*>(column.data()), count * sizeof(T));
+    }
+
+    static std::string readString(std::ifstream& file) {
+        std::string text;
+        std::getline(file, text, '\0');
+        return text;
+    }
+
+public:
+    ResultStore() : words(0) {}
+
+    // Empty store for results checked against `platforms`
+    explicit ResultStore(const PlatformTable& platforms) : words(0) {
+        for (const auto& platform : platforms) {
+            platformNames.push_back(platform.name);
+            templates.push_back(platform.urlTemplate());
+        }
+        index();
+    }
+
+    // Store over the same platform table, without any usernames
+    ResultStore emptyCopy() const {
+        ResultStore copy;
+        copy.platformNames = platformNames;
+        copy.templates = templates;
+        copy.index();
+        return copy;
+    }
+
+    // Interned ID of a platform name; false for a name not in the table
+    bool platformId(const std::string& name, uint32_t& id) const {
+        auto found = ids.find(name);
+        if (found == ids.end()) return false;
+        id = found->second;
+        return true;
+    }
+
+    // Append one username's results; `hits` may be in any order
+    void add(const std::string& username, std::vector<Hit> hits, size_t uncheckedCount) {
+        std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.platform < b.platform; });
+
+        names += username;
+        nameEnds.push_back(names.size());
+        size_t base = bits.size();
+        bits.resize(base + words, 0);
+        for (const Hit& hit : hits) {
+            bits[base + hit.platform / 64] |= 1ULL << (hit.platform % 64);
+            statuses.push_back(hit.status);
+        }
+        hitEnds.push_back(statuses.size());
+        unchecked.push_back((uint16_t)std::min<size_t>(uncheckedCount, UINT16_MAX));
+    }
+
+    size_t size() const { return nameEnds.size(); }
+    size_t platformCount() const { return platformNames.size(); }
+    const std::string& platformName(uint32_t id) const { return platformNames[id]; }
+
+    std::string username(size_t user) const {
+        size_t start = user == 0 ? 0 : nameEnds[user - 1];
+        return names.substr(start, nameEnds[user] - start);
+    }
+
+    size_t uncheckedCount(size_t user) const { return unchecked[user]; }
+
+    // Hits of one username in platform order, rebuilt from its bitset
+    void hits(size_t user, std::vector<Hit>& out) const {
+        out.clear();
+        size_t status = user == 0 ? 0 : hitEnds[user - 1];
+        for (uint32_t word = 0; word < words; word++) {
+            uint64_t set = bits[(size_t)user * words + word];
+            while (set) {
+                int bit = __builtin_ctzll(set);
+                set &= set - 1;
+                out.push_back({word * 64 + (uint32_t)bit, statuses[status++]});
+            }
+        }
+    }
+
+    // Profile URL of `name` on platform `id`
+    std::string url(uint32_t id, const std::string& name) const {
+        const std::string& urlTemplate = templates[id];
+        size_t placeholder = urlTemplate.find("%s");
+        if (placeholder == std::string::npos) return urlTemplate;
+        return urlTemplate.substr(0, placeholder) + name + urlTemplate.substr(placeholder + 2);
+    }
+
+    // Memory held by the columns, for progress reports
+    size_t bytes() const {
+        return names.capacity() + nameEnds.capacity() * sizeof(uint64_t) + bits.capacity() * sizeof(uint64_t) +
+               hitEnds.capacity() * sizeof(uint64_t) + unchecked.capacity() * sizeof(uint16_t) +
+               statuses.capacity() * sizeof(uint16_t);
+    }
+
+    // Write the store, replacing `path` atomically; `sync` also flushes it
+    // to disk before it takes the old file's place
+    bool save(const std::string& path, bool sync = false) const {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+
+            ResultFileHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, "YGRS", 4);
+            header.version = RESULT_STORE_VERSION;
+            header.platforms = (uint32_t)platformNames.size();
+            header.words = words;
+            header.users = nameEnds.size();
+            header.hits = statuses.size();
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            for (size_t i = 0; i < platformNames.size(); i++) {
+                file.write(platformNames[i].c_str(), platformNames[i].size() + 1);
+                file.write(templates[i].c_str(), templates[i].size() + 1);
+            }
+            writeColumn(file, nameEnds);
+            file.write(names.data(), names.size());
+            writeColumn(file, bits);
+            writeColumn(file, hitEnds);
+            writeColumn(file, unchecked);
+            writeColumn(file, statuses);
+            if (!file) return false;
+        }
+#ifndef _WIN32
+        if (sync) {
+            int fd = open(temp.c_str(), O_RDONLY);
+            bool ok = fd >= 0 && fsync(fd) == 0;
+            if (fd >= 0) close(fd);
+            if (!ok) return false;
+        }
+#endif
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            error = "could not open " + path;
+            return false;
+        }
+        uint64_t fileSize = (uint64_t)file.tellg();
+        file.seekg(0);
+
+        ResultFileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, "YGRS", 4) != 0 ||
+            header.version != RESULT_STORE_VERSION) {
+            error = path + " is not a version " + std::to_string(RESULT_STORE_VERSION) + " result file";
+            return false;
+        }
+
+        // Counts from a damaged header must not turn into huge allocations;
+        // a platform entry takes at least its two NUL terminators
+        if (header.platforms > fileSize / 2) {
+            error = path + " is truncated";
+            return false;
+        }
+        platformNames.clear();
+        templates.clear();
+        for (uint32_t i = 0; i < header.platforms; i++) {
+            platformNames.push_back(readString(file));
+            templates.push_back(readString(file));
+            if (!file || file.eof()) {
+                error = path + " is truncated";
+                return false;
+            }
+        }
+        index();
+        if (words != header.words) {
+            error = path + ": platform table does not match its bitset width";
+            return false;
+        }
+        if (header.users > fileSize / sizeof(uint64_t) || header.hits > fileSize / sizeof(uint16_t)) {
+            error = path + " is truncated";
+            return false;
+        }
+
+        bool ok = readColumn(file, nameEnds, header.users) && (nameEnds.empty() || nameEnds.back() <= fileSize);
+        names.resize(ok && !nameEnds.empty() ? nameEnds.back() : 0);
+        ok = ok && (names.empty() || file.read(&names[0], names.size()));
+        ok = ok && readColumn(file, bits, header.users * words) && readColumn(file, hitEnds, header.users) &&
+             readColumn(file, unchecked, header.users) && readColumn(file, statuses, header.hits);
+        if (!ok) {
+            error = path + " is truncated";
+            return false;
+        }
+
+        // Offsets must only grow, every bitset must match its status count and
+        // name only platforms in the table, and the statuses must all be used
+        uint64_t previousName = 0, previousHit = 0;
+        uint64_t unused = platformNames.size() % 64 == 0 ? 0 : ~0ULL << (platformNames.size() % 64);
+        for (size_t user = 0; user < nameEnds.size(); user++) {
+            uint64_t set = 0;
+            for (uint32_t word = 0; word < words; word++) set += __builtin_popcountll(bits[user * words + word]);
+            bool outside = words > 0 && (bits[user * words + words - 1] & unused) != 0;
+            if (nameEnds[user] < previousName || hitEnds[user] != previousHit + set || outside) {
+                error = path + " is corrupt at username " + std::to_string(user + 1);
+                return false;
+            }
+            previousName = nameEnds[user];
+            previousHit = hitEnds[user];
+        }
+        if (previousHit != statuses.size()) {
+            error = path + " is corrupt: " + std::to_string(statuses.size()) + " statuses for " +
+                    std::to_string(previousHit) + " hits";
+            return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include "check_job.hpp"
+
+// Lower-cased hostname of a URL (or URL template), without port
+inline std::string urlHost(const std::string& url) {
+    size_t start = url.find("://");
+    start = (start == std::string::npos) ? 0 : start + 3;
+    size_t end = url.find_first_of("/?#", start);
+    std::string host = url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+    size_t at = host.rfind('@');
+    if (at != std::string::npos) host.erase(0, at + 1);
+    size_t port = host.find(':');
+    if (port != std::string::npos) host.erase(port);
+    std::transform(host.begin(), host.end(), host.begin(), [](unsigned char c) { return std::tolower(c); });
+    return host;
+}
+
+// Politeness key for a URL template: the hostname with any leading
+// "%s." label removed, so wildcard subdomains ("%s.bandcamp.com")
+// share a single bucket with the rest of the site.
+inline std::string hostKey(const std::string& urlTemplate) {
+    std::string host = urlHost(urlTemplate);
+    if (host.compare(0, 3, "%s.") == 0) host.erase(0, 3);
+    return host;
+}
+
+// Per-host token bucket scheduler. Jobs are queued per host and handed out
+// round-robin across hosts, each host limited to `rate` requests per second
+// with bursts of up to `burst`; `maxInFlight` caps transfers across all hosts.
+class HostScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Host {
+        double tokens;
+        Clock::time_point refilled;
+        std::deque<CheckJob> queue;
+    };
+
+    double rate;
+    double burst;
+    size_t maxInFlight;
+    size_t inFlight;
+    size_t queued;
+    std::unordered_map<std::string, size_t> index;
+    std::vector<Host> hosts;
+    size_t cursor;
+
+    void refill(Host& host, Clock::time_point now) {
+        double elapsed = std::chrono::duration<double>(now - host.refilled).count();
+        host.tokens = std::min(burst, host.tokens + elapsed * rate);
+        host.refilled = now;
+    }
+
+public:
+    HostScheduler(double ratePerSec = 2.0, double burstSize = 2.0, size_t inFlightCap = 20)
+        : rate(ratePerSec > 0 ? ratePerSec : 1.0), burst(std::max(1.0, burstSize)),
+          maxInFlight(std::max<size_t>(1, inFlightCap)), inFlight(0), queued(0), cursor(0) {}
+
+    void push(CheckJob job) {
+        auto found = index.find(job.host);
+        if (found == index.end()) {
+            found = index.emplace(job.host, hosts.size()).first;
+            hosts.push_back({burst, Clock::now(), {}});
+        }
+        hosts[found->second].queue.push_back(std::move(job));
+        queued++;
+    }
+
+    // Hand out the next job whose host has a token available. When nothing
+    // is eligible, `wait` is lowered to the time until the next token.
+    bool pop(CheckJob& job, Clock::time_point now, Clock::duration& wait) {
+        if (queued == 0 || inFlight >= maxInFlight) return false;
+
+        for (size_t n = 0; n < hosts.size(); n++) {
+            Host& host = hosts[(cursor + n) % hosts.size()];
+            if (host.queue.empty()) continue;
+
+            refill(host, now);
+            if (host.tokens < 1.0) {
+                auto untilToken = std::chrono::duration<double>((1.0 - host.tokens) / rate);
+                wait = std::min(wait, std::chrono::duration_cast<Clock::duration>(untilToken) + Clock::duration(1));
+                continue;
+            }
+
+            host.tokens -= 1.0;
+            job = std::move(host.queue.front());
+            host.queue.pop_front();
+            queued--;
+            inFlight++;
+            cursor = (cursor + n + 1) % hosts.size();
+            return true;
+        }
+        return false;
+    }
+
+    // Take a token from `host` outside the queue (e.g. for a hedged
+    // duplicate of a running job); false if none is available right now
+    bool take(const std::string& host, Clock::time_point now) {
+        if (inFlight >= maxInFlight) return false;
+        auto found = index.find(host);
+        if (found == index.end()) return false;
+
+        Host& entry = hosts[found->second];
+        refill(entry, now);
+        if (entry.tokens < 1.0) return false;
+        entry.tokens -= 1.0;
+        inFlight++;
+        return true;
+    }
+
+    // Mark a previously popped (or taken) job as finished
+    void release() {
+        if (inFlight > 0) inFlight--;
+    }
+
+    // Move every queued job into `out`, e.g. when the run is cut short
+    void drain(std::vector<CheckJob>& out) {
+        for (auto& host : hosts) {
+            for (auto& job : host.queue) out.push_back(std::move(job));
+            host.queue.clear();
+        }
+        queued = 0;
+    }
+
+    size_t pending() const { return queued; }
+    size_t active() const { return inFlight; }
+};
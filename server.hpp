@@ -0,0 +1,341 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <cerrno>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include "sink.hpp"
+
+// One connection to the query socket. A query is a list of usernames, one
+// per line, ended by an empty line or by the client closing its side.
+// Lines starting with ':' are options:
+//   :checks   also stream one record per check, not just per username
+// Replies are NDJSON records, finished by {"done":true,...}.
+struct QueryClient {
+    int fd = -1;
+    bool wantChecks = false;
+    bool inputDone = false;     // the whole query has been read
+    bool gone = false;          // the client hung up; its work is skipped
+    bool finished = false;      // the done record has been queued
+    size_t outstanding = 0;     // usernames queued or being checked
+    size_t usernames = 0;
+    std::chrono::steady_clock::time_point started;
+    std::deque<std::string> outbox;
+    std::condition_variable ready;
+};
+
+// Unix domain socket front end for a resident checker. Each client gets
+// a thread that reads its query and writes its replies; the usernames of
+// all clients are merged into one queue that the checker drains, so
+// concurrent queries share the same engine, connections and rate limits.
+class QueryServer {
+private:
+    using ClientPtr = std::shared_ptr<QueryClient>;
+
+    struct Handler {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    int listener;
+    std::string socketPath;
+    std::atomic<bool> stopping;
+    std::thread acceptor;
+    std::vector<Handler> handlers;
+    std::mutex mutex;
+    std::condition_variable work;
+    std::deque<std::pair<ClientPtr, std::string>> queue;
+    std::vector<ClientPtr> clients;
+    std::function<void()> onWork;
+    size_t queries;
+
+    // Queue the done record once the query is read and fully answered.
+    // Called with `mutex` held.
+    void maybeFinish(QueryClient& client) {
+        if (!client.inputDone || client.outstanding > 0 || client.finished) return;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - client.started).count();
+        char elapsed[32];
+        snprintf(elapsed, sizeof(elapsed), "%.3f", seconds);
+        client.outbox.push_back("{\"done\":true,\"usernames\":" + std::to_string(client.usernames) +
+                                ",\"seconds\":" + elapsed + "}\n");
+        client.finished = true;
+        client.ready.notify_one();
+    }
+
+#ifndef _WIN32
+    void readQuery(const ClientPtr& client) {
+        std::string buffer;
+        char chunk[4096];
+        bool ended = false;
+        while (!ended) {
+            ssize_t got = recv(client->fd, chunk, sizeof(chunk), 0);
+            if (got <= 0) break;
+            buffer.append(chunk, got);
+
+            size_t eol;
+            while (!ended && (eol = buffer.find('\n')) != std::string::npos) {
+                std::string line = buffer.substr(0, eol);
+                buffer.erase(0, eol + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.empty()) {
+                    ended = true;
+                } else {
+                    addLine(client, line);
+                }
+            }
+        }
+        // A last line without a newline still counts
+        if (!ended && !buffer.empty()) addLine(client, buffer);
+
+        std::lock_guard<std::mutex> guard(mutex);
+        client->inputDone = true;
+        maybeFinish(*client);
+    }
+
+    void addLine(const ClientPtr& client, const std::string& line) {
+        if (line[0] == ':') {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (line == ":checks") client->wantChecks = true;
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            client->outstanding++;
+            client->usernames++;
+            queue.emplace_back(client, line);
+        }
+        work.notify_one();
+        if (onWork) onWork();
+    }
+
+    void writeReplies(const ClientPtr& client) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            client->ready.wait(lock, [&] { return !client->outbox.empty() || stopping; });
+            if (client->outbox.empty()) return;
+
+            std::string chunk;
+            while (!client->outbox.empty()) {
+                chunk += client->outbox.front();
+                client->outbox.pop_front();
+            }
+            bool last = client->finished;
+            lock.unlock();
+
+            size_t sent = 0;
+            while (sent < chunk.size()) {
+                ssize_t wrote = ::send(client->fd, chunk.data() + sent, chunk.size() - sent, MSG_NOSIGNAL);
+                if (wrote <= 0) break;
+                sent += wrote;
+            }
+
+            lock.lock();
+            if (sent < chunk.size()) {
+                client->gone = true;
+                return;
+            }
+            if (last && client->outbox.empty()) return;
+        }
+    }
+
+    void serve(ClientPtr client) {
+        std::thread writer(&QueryServer::writeReplies, this, client);
+        readQuery(client);
+        writer.join();
+
+        std::lock_guard<std::mutex> guard(mutex);
+        // Anything still queued for a client that left is dropped by next()
+        if (!client->finished) client->gone = true;
+        ::close(client->fd);
+        client->fd = -1;
+        clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+    }
+
+    void acceptLoop() {
+        while (!stopping) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            ClientPtr client = std::make_shared<QueryClient>();
+            client->fd = fd;
+            client->started = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> guard(mutex);
+            if (stopping) {
+                ::close(fd);
+                break;
+            }
+            clients.push_back(client);
+            queries++;
+
+            // Reap handlers of finished connections
+            for (auto it = handlers.begin(); it != handlers.end();) {
+                if (*it->done) {
+                    it->thread.join();
+                    it = handlers.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            auto done = std::make_shared<std::atomic<bool>>(false);
+            handlers.push_back({std::thread([this, client, done] {
+                serve(client);
+                *done = true;
+            }), done});
+        }
+    }
+#endif
+
+public:
+    QueryServer() : listener(-1), stopping(false), queries(0) {}
+
+    ~QueryServer() { stop(); }
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    // Called whenever usernames are queued, e.g. to wake the engine
+    void setWakeup(const std::function<void()>& wakeup) { onWork = wakeup; }
+
+    // Listen on `path`. A stale socket left by a previous run is replaced;
+    // one that still accepts connections is an error.
+    bool start(const std::string& path, std::string& error) {
+#ifndef _WIN32
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            error = "socket path must be 1 to " + std::to_string(sizeof(address.sun_path) - 1) + " characters";
+            return false;
+        }
+        memcpy(address.sun_path, path.c_str(), path.size());
+
+        struct stat info;
+        if (lstat(path.c_str(), &info) == 0) {
+            if (!S_ISSOCK(info.st_mode)) {
+                error = path + " exists and is not a socket";
+                return false;
+            }
+            int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+            bool live = probe >= 0 && connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+            if (probe >= 0) ::close(probe);
+            if (live) {
+                error = "another server is already listening on " + path;
+                return false;
+            }
+            unlink(path.c_str());
+        }
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            error = std::string("could not create socket: ") + strerror(errno);
+            return false;
+        }
+        // Owner only: queries run with the daemon's network identity
+        mode_t previous = umask(0177);
+        bool bound = bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        umask(previous);
+        if (!bound || listen(listener, 64) != 0) {
+            error = "could not listen on " + path + ": " + strerror(errno);
+            ::close(listener);
+            listener = -1;
+            return false;
+        }
+
+        socketPath = path;
+        acceptor = std::thread(&QueryServer::acceptLoop, this);
+        return true;
+#else
+        (void)path;
+        error = "--serve is not supported on this platform";
+        return false;
+#endif
+    }
+
+    // Stop accepting, hang up on every client and remove the socket
+    void stop() {
+#ifndef _WIN32
+        if (listener < 0) return;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            stopping = true;
+            for (auto& client : clients) {
+                if (client->fd >= 0) shutdown(client->fd, SHUT_RDWR);
+                client->ready.notify_one();
+            }
+        }
+        shutdown(listener, SHUT_RDWR);
+        acceptor.join();
+        ::close(listener);
+        listener = -1;
+        unlink(socketPath.c_str());
+
+        for (auto& handler : handlers) handler.thread.join();
+        handlers.clear();
+        work.notify_all();
+#endif
+    }
+
+    // Wait up to `waitMs` for queued usernames; true when there are some
+    bool waitForWork(int waitMs) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return work.wait_for(lock, std::chrono::milliseconds(waitMs), [this] { return !queue.empty() || stopping; }) &&
+               !queue.empty();
+    }
+
+    // Next queued username across all clients, in arrival order. Usernames
+    // of clients that hung up are dropped.
+    bool next(std::shared_ptr<QueryClient>& client, std::string& username) {
+        std::lock_guard<std::mutex> guard(mutex);
+        while (!queue.empty()) {
+            client = std::move(queue.front().first);
+            username = std::move(queue.front().second);
+            queue.pop_front();
+            if (!client->gone && !stopping) return true;
+            client->outstanding--;
+        }
+        return false;
+    }
+
+    // Queue one NDJSON record for `client`; the newline is added here
+    void send(const std::shared_ptr<QueryClient>& client, const std::string& record) {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (client->gone) return;
+        client->outbox.push_back(record + "\n");
+        client->ready.notify_one();
+    }
+
+    bool wantsChecks(const std::shared_ptr<QueryClient>& client) {
+        std::lock_guard<std::mutex> guard(mutex);
+        return client->wantChecks;
+    }
+
+    // One username of `client` has been fully answered
+    void finish(const std::shared_ptr<QueryClient>& client) {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (client->outstanding > 0) client->outstanding--;
+        maybeFinish(*client);
+    }
+
+    size_t queryCount() {
+        std::lock_guard<std::mutex> guard(mutex);
+        return queries;
+    }
+};
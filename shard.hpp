@@ -0,0 +1,245 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+// Version of the work directory layout understood by this build
+#define WORK_DIR_VERSION 1
+
+// Run-wide settings the coordinator publishes for its workers
+struct ShardJob {
+    size_t shards = 0;
+    int workers = 1;          // worker slots; the per-host rate is split between them
+    double hostRate = 2.0;    // global requests per second per host
+    double hostBurst = 2.0;
+};
+
+// A directory shared by one coordinator and any number of workers, on one
+// box or on a network filesystem:
+//
+//   job.tsv             settings; written last, so its presence means ready
+//   platforms.tsv       the platform database every worker must use
+//   shards/N.txt        usernames of shard N, one per line
+//   leases/N.lease      claimed by a worker (O_EXCL); its mtime is the heartbeat
+//   slots/N.lease       worker slot N < workers, leased like a shard; a worker
+//                       only claims shards while it holds a slot
+//   results/N.ygr       the shard's ResultStore; its presence means done
+//   complete            written by the coordinator once everything is merged
+//
+// Every state change is a single create, rename or unlink, so no locking is
+// needed beyond what the filesystem already guarantees.
+class WorkDirectory {
+private:
+    std::string root;
+
+    static std::string shardName(size_t shard) {
+        char name[24];
+        snprintf(name, sizeof(name), "%06zu", shard);
+        return name;
+    }
+
+    static bool exists(const std::string& path) {
+#ifndef _WIN32
+        struct stat info;
+        return stat(path.c_str(), &info) == 0;
+#else
+        return std::ifstream(path).is_open();
+#endif
+    }
+
+    static bool makeDirectory(const std::string& path, std::string& error) {
+#ifndef _WIN32
+        if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+            error = "could not create " + path + ": " + strerror(errno);
+            return false;
+        }
+        return true;
+#else
+        error = "work directories are not supported on this platform";
+        return false;
+#endif
+    }
+
+    static bool takeLease(const std::string& path, const std::string& worker) {
+#ifndef _WIN32
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd < 0) return false;
+        std::string owner = worker + "\n";
+        bool ok = write(fd, owner.data(), owner.size()) == (ssize_t)owner.size();
+        close(fd);
+        return ok;
+#else
+        (void)path;
+        (void)worker;
+        return false;
+#endif
+    }
+
+    static void touchLease(const std::string& path) {
+#ifndef _WIN32
+        utime(path.c_str(), nullptr);
+#else
+        (void)path;
+#endif
+    }
+
+    static long leaseAgeOf(const std::string& path) {
+#ifndef _WIN32
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return -1;
+        return (long)(time(nullptr) - info.st_mtime);
+#else
+        (void)path;
+        return -1;
+#endif
+    }
+
+    static std::string leaseOwnerOf(const std::string& path) {
+        std::ifstream file(path);
+        std::string owner;
+        std::getline(file, owner);
+        return owner;
+    }
+
+    static bool writeAtomically(const std::string& path, const std::string& content) {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file << content;
+            if (!file) return false;
+        }
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+
+public:
+    explicit WorkDirectory(const std::string& directory) : root(directory) {}
+
+    const std::string& path() const { return root; }
+    std::string shardPath(size_t shard) const { return root + "/shards/" + shardName(shard) + ".txt"; }
+    std::string leasePath(size_t shard) const { return root + "/leases/" + shardName(shard) + ".lease"; }
+    std::string resultPath(size_t shard) const { return root + "/results/" + shardName(shard) + ".ygr"; }
+    std::string slotPath(int slot) const { return root + "/slots/" + shardName((size_t)slot) + ".lease"; }
+    std::string platformsPath() const { return root + "/platforms.tsv"; }
+
+    // A coordinator restarted on the same directory resumes its job
+    bool hasJob() const { return exists(root + "/job.tsv"); }
+
+    // Create the layout for a new run
+    bool create(std::string& error) {
+        if (!makeDirectory(root, error)) return false;
+        return makeDirectory(root + "/shards", error) && makeDirectory(root + "/leases", error) &&
+               makeDirectory(root + "/slots", error) && makeDirectory(root + "/results", error);
+    }
+
+    bool writeShard(size_t shard, const std::string& usernames) { return writeAtomically(shardPath(shard), usernames); }
+
+    bool writePlatforms(const std::string& database) { return writeAtomically(platformsPath(), database); }
+
+    bool publish(const ShardJob& job) {
+        std::ostringstream text;
+        text << "yougoldberg-work\t" << WORK_DIR_VERSION << "\n"
+             << "shards\t" << job.shards << "\n"
+             << "workers\t" << job.workers << "\n"
+             << "rate\t" << job.hostRate << "\n"
+             << "burst\t" << job.hostBurst << "\n";
+        return writeAtomically(root + "/job.tsv", text.str());
+    }
+
+    // False while the coordinator is still writing shards
+    bool readJob(ShardJob& job, std::string& error) const {
+        std::ifstream file(root + "/job.tsv");
+        if (!file.is_open()) {
+            error = root + " has no job yet";
+            return false;
+        }
+
+        std::string line;
+        std::string magic;
+        int version = 0;
+        if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) || magic != "yougoldberg-work" ||
+            version != WORK_DIR_VERSION) {
+            error = root + "/job.tsv is not a version " + std::to_string(WORK_DIR_VERSION) + " job file";
+            return false;
+        }
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string key;
+            fields >> key;
+            if (key == "shards") fields >> job.shards;
+            else if (key == "workers") fields >> job.workers;
+            else if (key == "rate") fields >> job.hostRate;
+            else if (key == "burst") fields >> job.hostBurst;
+        }
+        // Each worker's share of the burst must be at least one request
+        job.workers = std::max(1, std::min(job.workers, (int)job.hostBurst));
+        return true;
+    }
+
+    bool isDone(size_t shard) const { return exists(resultPath(shard)); }
+    bool isLeased(size_t shard) const { return exists(leasePath(shard)); }
+    bool isComplete() const { return exists(root + "/complete"); }
+    void markComplete() { writeAtomically(root + "/complete", ""); }
+
+    // Take the lease on `shard`; false if another worker holds it
+    bool claim(size_t shard, const std::string& worker) { return takeLease(leasePath(shard), worker); }
+
+    // Prove the lease holder is alive
+    void heartbeat(size_t shard) { touchLease(leasePath(shard)); }
+
+    // Seconds since the lease holder last proved it was alive, -1 if unleased
+    long leaseAge(size_t shard) const { return leaseAgeOf(leasePath(shard)); }
+
+    // Who holds the lease on `shard`
+    std::string leaseOwner(size_t shard) const { return leaseOwnerOf(leasePath(shard)); }
+
+    // Drop a dead worker's lease so the shard can be claimed again
+    void reissue(size_t shard) { std::remove(leasePath(shard).c_str()); }
+
+    // Worker slots work like shard leases: a worker claims the first free
+    // slot below the job's worker count and holds it until it exits, so no
+    // more than `workers` workers ever share the per-host rate
+    bool claimSlot(int slot, const std::string& worker) { return takeLease(slotPath(slot), worker); }
+    void heartbeatSlot(int slot) { touchLease(slotPath(slot)); }
+    long slotAge(int slot) const { return leaseAgeOf(slotPath(slot)); }
+    std::string slotOwner(int slot) const { return leaseOwnerOf(slotPath(slot)); }
+    void releaseSlot(int slot) { std::remove(slotPath(slot).c_str()); }
+
+    // Results of `shard` are written by the worker under a temporary name
+    // and renamed into place, so a partial file is never seen as done
+    std::string resultTempPath(size_t shard, const std::string& worker) const {
+        std::string safe = worker;
+        std::replace(safe.begin(), safe.end(), '/', '_');
+        return resultPath(shard) + "." + safe + ".tmp";
+    }
+
+    // "host:pid", unique among the workers sharing a directory
+    static std::string workerId() {
+#ifndef _WIN32
+        char host[256] = "localhost";
+        gethostname(host, sizeof(host) - 1);
+        return std::string(host) + ":" + std::to_string(getpid());
+#else
+        return "worker";
+#endif
+    }
+
+    bool finish(size_t shard, const std::string& tempPath) {
+        if (std::rename(tempPath.c_str(), resultPath(shard).c_str()) != 0) return false;
+        std::remove(leasePath(shard).c_str());
+        return true;
+    }
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include "curl_compat.hpp"
+
+// Counters for the shared connection layer. A transfer that reused a
+// pooled connection skipped DNS, TCP and TLS entirely. curl does not say
+// whether a fresh connection's name came from its DNS cache (the lookup
+// time is never zero, even for a hit), so DNS hits are an estimate: a
+// fresh connection to a host this process opened a connection to within
+// the DNS cache lifetime counts as a hit, even if curl evicted the entry
+// early.
+struct ShareStats {
+    size_t dnsHits = 0;      // estimated, see above
+    size_t dnsMisses = 0;    // estimated
+    size_t connectionsReused = 0;
+    size_t connectionsOpened = 0;
+};
+
+// DNS cache, TLS session IDs and the connection pool shared by every easy
+// handle that attaches to it, safe to use from several threads.
+class ConnectionShare {
+private:
+    CURLSH* share;
+    std::mutex locks[CURL_LOCK_DATA_LAST];
+    std::mutex statsMutex;
+    ShareStats stats;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> resolvedAt;
+    long dnsTimeout;
+
+    static void lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+        static_cast<ConnectionShare*>(userptr)->locks[data].lock();
+    }
+
+    static void unlock(CURL*, curl_lock_data data, void* userptr) {
+        static_cast<ConnectionShare*>(userptr)->locks[data].unlock();
+    }
+
+public:
+    explicit ConnectionShare(long dnsCacheSecs = 300)
+        : share(curl_share_init()), dnsTimeout(dnsCacheSecs) {
+        if (share) {
+            curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lock);
+            curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlock);
+            curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        }
+    }
+
+    ~ConnectionShare() {
+        if (share) {
+            curl_share_cleanup(share);
+        }
+    }
+
+    ConnectionShare(const ConnectionShare&) = delete;
+    ConnectionShare& operator=(const ConnectionShare&) = delete;
+
+    // Attach an easy handle; must be detached (or cleaned up) before the share
+    void attach(CURL* easy) {
+        if (!share) return;
+        curl_easy_setopt(easy, CURLOPT_SHARE, share);
+        curl_easy_setopt(easy, CURLOPT_DNS_CACHE_TIMEOUT, dnsTimeout);
+    }
+
+    // Record how a finished transfer to `host` got its connection
+    void recordTransfer(const std::string& host, long newConnections) {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> guard(statsMutex);
+
+        if (newConnections == 0) {
+            stats.connectionsReused++;
+            return;
+        }
+        stats.connectionsOpened += newConnections;
+
+        auto found = resolvedAt.find(host);
+        if (found != resolvedAt.end() && now - found->second < std::chrono::seconds(dnsTimeout)) {
+            stats.dnsHits++;
+        } else {
+            stats.dnsMisses++;
+            resolvedAt[host] = now;
+        }
+    }
+
+    ShareStats snapshot() {
+        std::lock_guard<std::mutex> guard(statsMutex);
+        return stats;
+    }
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <string>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include "check_job.hpp"
+
+// Escape a string for inclusion in a JSON string literal
+inline std::string jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    return out;
+}
+
+// Newline-delimited JSON writer. Records are appended to an in-memory
+// buffer by the caller and written out by a dedicated thread whenever the
+// buffer passes `flushBytes` or `flushInterval` has elapsed, so readers
+// tailing the file see results while the search is still running.
+class NDJSONSink {
+private:
+    FILE* file;
+    std::string buffer;
+    size_t flushBytes;
+    std::chrono::milliseconds flushInterval;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool closing;
+    std::thread writer;
+
+    void writerLoop() {
+        std::string chunk;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait_for(lock, flushInterval, [this] { return closing || buffer.size() >= flushBytes; });
+
+            chunk.swap(buffer);
+            bool done = closing;
+            lock.unlock();
+
+            if (!chunk.empty()) {
+                fwrite(chunk.data(), 1, chunk.size(), file);
+                fflush(file);
+                chunk.clear();
+            }
+            if (done) return;
+            lock.lock();
+        }
+    }
+
+public:
+    NDJSONSink(size_t flushAfterBytes = 64 * 1024,
+               std::chrono::milliseconds flushAfter = std::chrono::milliseconds(1000))
+        : file(nullptr), flushBytes(flushAfterBytes), flushInterval(flushAfter), closing(false) {}
+
+    ~NDJSONSink() { close(); }
+
+    NDJSONSink(const NDJSONSink&) = delete;
+    NDJSONSink& operator=(const NDJSONSink&) = delete;
+
+    bool open(const std::string& path, bool append = false) {
+        file = fopen(path.c_str(), append ? "a" : "w");
+        if (!file) return false;
+        writer = std::thread(&NDJSONSink::writerLoop, this);
+        return true;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Queue one complete JSON object; the newline is added here
+    void write(const std::string& record) {
+        std::lock_guard<std::mutex> guard(mutex);
+        buffer += record;
+        buffer += '\n';
+        if (buffer.size() >= flushBytes) wake.notify_one();
+    }
+
+    // Drain everything queued so far and stop the writer thread
+    void close() {
+        if (!file) return;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            closing = true;
+        }
+        wake.notify_one();
+        writer.join();
+        fclose(file);
+        file = nullptr;
+    }
+};
+
+// One NDJSON record for a completed check, negatives included
+inline std::string formatCheckRecord(const std::string& username, const CheckOutcome& outcome) {
+    char timing[32];
+    snprintf(timing, sizeof(timing), "%.1f", outcome.seconds * 1000.0);
+    long long now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::string record = "{\"username\":\"" + jsonEscape(username) +
+                         "\",\"platform\":\"" + jsonEscape(outcome.job.platform) +
+                         "\",\"url\":\"" + jsonEscape(outcome.job.url) +
+                         "\",\"status\":" + std::to_string(outcome.responseCode) +
+                         ",\"found\":" + (outcome.found ? "true" : "false") + ",\"error\":";
+    if (outcome.skipped) {
+        record += "\"skipped: host unhealthy\"";
+    } else if (outcome.cancelled) {
+        record += "\"cancelled: deadline\"";
+    } else if (outcome.error == CURLE_OK) {
+        record += "null";
+    } else {
+        record += "\"" + jsonEscape(curl_easy_strerror(outcome.error)) + "\"";
+    }
+    char phases[128];
+    snprintf(phases, sizeof(phases), ",\"dns_ms\":%.1f,\"connect_ms\":%.1f,\"tls_ms\":%.1f,\"ttfb_ms\":%.1f,\"bytes\":%lld",
+             outcome.timing.dns * 1000.0, outcome.timing.connect * 1000.0, outcome.timing.tls * 1000.0,
+             outcome.timing.ttfb * 1000.0, outcome.timing.bytes);
+    record += ",\"time_ms\":" + std::string(timing) + phases + ",\"cached\":" + (outcome.cached ? "true" : "false") +
+              ",\"ts\":" + std::to_string(now) + "}";
+    return record;
+}
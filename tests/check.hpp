@@ -0,0 +1,34 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+
+// Minimal assertions for the unit tests: a failed CHECK reports the
+// expression and the test keeps going; main() returns the failure count.
+static int failures = 0;
+
+#define CHECK(expr)                                                                   \
+    do {                                                                              \
+        if (!(expr)) {                                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #expr ") failed\n"; \
+            failures++;                                                               \
+        }                                                                             \
+    } while (0)
+
+// Fresh scratch directory under $TMPDIR (or /tmp)
+inline std::string scratchDirectory() {
+    const char* base = getenv("TMPDIR");
+    std::string path = std::string(base && *base ? base : "/tmp") + "/yougoldberg-test.XXXXXX";
+    if (!mkdtemp(&path[0])) {
+        std::cerr << "could not create a scratch directory\n";
+        exit(1);
+    }
+    return path;
+}
+
+inline int report(const char* suite) {
+    if (failures == 0) std::cout << suite << ": all checks passed\n";
+    else std::cout << suite << ": " << failures << " check(s) failed\n";
+    return failures == 0 ? 0 : 1;
+}
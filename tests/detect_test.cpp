@@ -0,0 +1,72 @@
+// BodyScanner: markers must be found wherever the body is split into chunks
+#include <string>
+#include "detect.hpp"
+#include "check.hpp"
+
+// Feed `body` to a scanner in chunks of `chunk` bytes
+static BodyScanner scanChunks(const DetectRule& rule, const std::string& body, size_t chunk) {
+    BodyScanner scanner;
+    scanner.reset(&rule, 0);
+    for (size_t at = 0; at < body.size(); at += chunk) {
+        if (scanner.feed(body.data() + at, std::min(chunk, body.size() - at))) break;
+    }
+    return scanner;
+}
+
+static void testFoundMarkerSplit() {
+    DetectRule rule;
+    rule.foundMarker = "profile-card";
+    std::string body = "<html><div class=\"profile-card\">jdoe</div></html>";
+
+    for (size_t chunk = 1; chunk <= body.size(); chunk++) {
+        BodyScanner scanner = scanChunks(rule, body, chunk);
+        CHECK(scanner.sawFound);
+        CHECK(!scanner.sawNotFound);
+        CHECK(profileFound(&rule, 200, "", scanner));
+    }
+}
+
+static void testNotFoundMarkerSplit() {
+    DetectRule rule;
+    rule.foundMarker = "og:title";
+    rule.notFoundMarker = "Page not found";
+    std::string body = "<meta property=\"og:title\">... <h1>Page not found</h1>";
+
+    for (size_t chunk = 1; chunk <= body.size(); chunk++) {
+        BodyScanner scanner = scanChunks(rule, body, chunk);
+        CHECK(scanner.sawNotFound);
+        CHECK(!profileFound(&rule, 200, "", scanner));
+    }
+}
+
+// Split positions must not invent a marker out of unrelated pieces
+static void testNoFalseMatch() {
+    DetectRule rule;
+    rule.foundMarker = "abcabd";
+    std::string body = "xxabcabcabxdabcab";
+
+    for (size_t chunk = 1; chunk <= body.size(); chunk++) {
+        CHECK(!scanChunks(rule, body, chunk).sawFound);
+    }
+    CHECK(scanChunks(rule, body + "d", 2).sawFound);
+}
+
+static void testByteCap() {
+    DetectRule rule;
+    rule.foundMarker = "needle";
+    std::string body = std::string(64, 'x') + "needle";
+
+    BodyScanner scanner;
+    scanner.reset(&rule, 32);
+    CHECK(!scanner.feed(body.data(), 16));
+    CHECK(scanner.feed(body.data() + 16, 16));
+    CHECK(!scanner.sawFound);
+}
+
+int main() {
+    testFoundMarkerSplit();
+    testNotFoundMarkerSplit();
+    testNoFalseMatch();
+    testByteCap();
+    return report("detect");
+}
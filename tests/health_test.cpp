@@ -0,0 +1,99 @@
+// HostHealth: the circuit breaker opens after repeated host failures, lets
+// one probe through once the cooldown has passed, and closes on success
+#include <string>
+#include <fstream>
+#include <ctime>
+#include "health.hpp"
+#include "check.hpp"
+
+static void testOpens() {
+    HostHealth health(3, 3600);
+    health.record("a.example", CURLE_COULDNT_CONNECT);
+    health.record("a.example", CURLE_OPERATION_TIMEDOUT);
+    CHECK(health.stateOf("a.example") == HostHealth::Closed);
+    CHECK(health.admit("a.example"));
+
+    health.record("a.example", CURLE_COULDNT_RESOLVE_HOST);
+    CHECK(health.stateOf("a.example") == HostHealth::Open);
+    CHECK(!health.admit("a.example"));
+    CHECK(health.blocked("a.example"));
+    CHECK(health.skippedCount() == 2);
+    CHECK(health.unhealthyCount() == 1);
+
+    // Other hosts are unaffected
+    CHECK(health.admit("b.example"));
+}
+
+// An answer, even an error status, resets the failure count
+static void testAnswerResets() {
+    HostHealth health(2, 3600);
+    health.record("a.example", CURLE_COULDNT_CONNECT);
+    health.record("a.example", CURLE_OK);
+    health.record("a.example", CURLE_COULDNT_CONNECT);
+    CHECK(health.stateOf("a.example") == HostHealth::Closed);
+    health.record("a.example", CURLE_RECV_ERROR);
+    health.record("a.example", CURLE_COULDNT_CONNECT);
+    CHECK(health.stateOf("a.example") == HostHealth::Closed);
+}
+
+static void testHalfOpen() {
+    HostHealth health(1, 0);
+    health.record("a.example", CURLE_COULDNT_CONNECT);
+    CHECK(health.stateOf("a.example") == HostHealth::HalfOpen);
+
+    // Exactly one probe at a time
+    CHECK(health.admit("a.example"));
+    CHECK(!health.admit("a.example"));
+    CHECK(!health.blocked("a.example"));
+
+    health.record("a.example", CURLE_OK);
+    CHECK(health.stateOf("a.example") == HostHealth::Closed);
+    CHECK(health.admit("a.example"));
+    CHECK(health.admit("a.example"));
+}
+
+// A failed probe re-opens the breaker for another full cooldown
+static void testProbeFails(const std::string& directory) {
+    std::string path = directory + "/health.tsv";
+    {
+        std::ofstream file(path);
+        file << "yougoldberg-health\t1\n"
+             << "a.example\t3\t" << (long long)time(nullptr) - 120 << "\n";
+    }
+
+    HostHealth health(3, 60);
+    std::string error;
+    CHECK(health.load(path, error));
+    CHECK(health.stateOf("a.example") == HostHealth::HalfOpen);
+    CHECK(health.admit("a.example"));
+
+    health.record("a.example", CURLE_OPERATION_TIMEDOUT);
+    CHECK(health.stateOf("a.example") == HostHealth::Open);
+    CHECK(!health.admit("a.example"));
+
+    CHECK(health.save(path));
+    HostHealth reloaded(3, 60);
+    CHECK(reloaded.load(path, error));
+    CHECK(reloaded.stateOf("a.example") == HostHealth::Open);
+    std::remove(path.c_str());
+}
+
+// A failed lookup of a per-user subdomain says nothing about the site
+static void testPerUserName() {
+    HostHealth health(1, 3600);
+    health.record("ghost.io", CURLE_COULDNT_RESOLVE_HOST, true);
+    CHECK(health.stateOf("ghost.io") == HostHealth::Closed);
+    health.record("ghost.io", CURLE_COULDNT_CONNECT, true);
+    CHECK(health.stateOf("ghost.io") == HostHealth::Open);
+}
+
+int main() {
+    std::string directory = scratchDirectory();
+    testOpens();
+    testAnswerResets();
+    testHalfOpen();
+    testProbeFails(directory);
+    testPerUserName();
+    rmdir(directory.c_str());
+    return report("health");
+}
@@ -0,0 +1,258 @@
+// RunJournal: checks journaled by an interrupted run are answered on resume,
+// and torn or damaged journal records are ignored
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include "journal.hpp"
+#include "check.hpp"
+
+static PlatformTable platformTable() {
+    PlatformTable platforms;
+    std::string error;
+    CHECK(platforms.loadText("yougoldberg-platforms\t1\n"
+                             "Alpha\thttps://alpha.example/%s\n"
+                             "Beta\thttps://beta.example/%s\n"
+                             "Gamma\thttps://gamma.example/%s\n",
+                             "<test>", error));
+    return platforms;
+}
+
+static CheckOutcome verdict(const Platform& platform, const std::string& username, long status) {
+    CheckOutcome outcome{};
+    platform.buildURL(username, outcome.job.url);
+    outcome.job.platform = platform.name;
+    outcome.job.host = platform.host;
+    outcome.error = CURLE_OK;
+    outcome.responseCode = status;
+    outcome.found = status == 200;
+    return outcome;
+}
+
+// First run: "alice" completes, "bob" is interrupted after one check
+static std::string interruptedRun(const std::string& directory, const PlatformTable& platforms) {
+    std::string batch = directory + "/batch.txt";
+    std::ofstream(batch) << "alice\nbob\ncarol\n";
+
+    RunJournal journal;
+    std::string error;
+    CHECK(journal.create(directory + "/run", batch, "", platforms, error));
+    for (const auto& platform : platforms) journal.record(1, verdict(platform, "alice", platform.name == "Beta" ? 200 : 404));
+    journal.finish(1, "alice");
+    journal.record(2, verdict(platforms[0], "bob", 200));
+    CHECK(journal.close());
+    return batch;
+}
+
+static void testResume(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string batch = interruptedRun(directory, platforms);
+
+    std::string batchFile, platformsFile, error;
+    CHECK(RunJournal::readRun(directory + "/run", batchFile, platformsFile, error));
+    CHECK(platformsFile.empty());
+
+    RunJournal journal;
+    CHECK(journal.resume(directory + "/run", platforms, error));
+    CHECK(journal.checkpoint().size() == 1);
+    CHECK(journal.checkpoint().username(0) == "alice");
+    std::vector<ResultStore::Hit> hits;
+    journal.checkpoint().hits(0, hits);
+    CHECK(hits.size() == 1 && journal.checkpoint().platformName(hits[0].platform) == "Beta");
+    CHECK(journal.journaledChecks() == 1);
+
+    // The resumed search starts at "bob"
+    CheckOutcome outcome;
+    CheckJob job = verdict(platforms[0], "bob", 0).job;
+    CHECK(journal.recall(1, job, outcome));
+    CHECK(outcome.cached && outcome.found && outcome.responseCode == 200);
+    CHECK(!journal.recall(1, verdict(platforms[1], "bob", 0).job, outcome));
+    CHECK(!journal.recall(2, job, outcome));
+    CHECK(journal.recalledChecks() == 1);
+    journal.close();
+
+    std::remove(batch.c_str());
+}
+
+// A username with failed or skipped checks is still checkpointed, with
+// them as its unchecked count; a resumed run sends just those again
+static void testFailedChecks(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string batch = directory + "/batch.txt";
+    std::ofstream(batch) << "alice\nbob\n";
+
+    RunJournal journal;
+    std::string error;
+    CHECK(journal.create(directory + "/run", batch, "", platforms, error));
+    CheckOutcome failed = verdict(platforms[0], "alice", 0);
+    failed.error = CURLE_OPERATION_TIMEDOUT;
+    CheckOutcome skipped = verdict(platforms[1], "alice", 0);
+    skipped.skipped = true;
+    CHECK(!journal.record(1, failed));
+    CHECK(!journal.record(1, skipped));
+    CHECK(journal.record(1, verdict(platforms[2], "alice", 404)));
+    journal.finish(1, "alice");
+    CHECK(journal.checkpoint().size() == 1);
+    CHECK(journal.checkpoint().uncheckedCount(0) == 2);
+    CHECK(journal.missingCount() == 2);
+    CHECK(journal.close());
+
+    RunJournal resumed;
+    CHECK(resumed.resume(directory + "/run", platforms, error));
+    CHECK(resumed.checkpoint().size() == 1);
+    CHECK(resumed.checkpoint().uncheckedCount(0) == 2);
+    CHECK(resumed.journaledChecks() == 0);
+    CHECK(resumed.missingCount() == 2);
+    CHECK(resumed.missingCount() == 2 && resumed.missingCheck(0).platform == 0 && resumed.missingCheck(1).platform == 1);
+
+    // Alpha answers this time, Beta is skipped again
+    CHECK(resumed.resolve(0, verdict(platforms[0], "alice", 200)));
+    CHECK(!resumed.resolve(1, skipped));
+    CHECK(resumed.applyResolved());
+    CHECK(resumed.missingCount() == 1);
+    CHECK(resumed.checkpoint().uncheckedCount(0) == 1);
+    std::vector<ResultStore::Hit> hits;
+    resumed.checkpoint().hits(0, hits);
+    CHECK(hits.size() == 1 && hits[0].platform == 0 && hits[0].status == 200);
+    resumed.close();
+
+    RunJournal again;
+    CHECK(again.resume(directory + "/run", platforms, error));
+    CHECK(again.checkpoint().uncheckedCount(0) == 1);
+    CHECK(again.missingCount() == 1 && again.missingCheck(0).platform == 1);
+    again.close();
+
+    std::remove(batch.c_str());
+}
+
+// One host that never answers must not stop the checkpoint from moving:
+// after a complete run every username is in it and the journal holds only
+// the missing checks
+static void testCompaction(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string batch = directory + "/batch.txt";
+    {
+        std::ofstream file(batch);
+        for (int i = 1; i <= 21; i++) file << "user" << i << "\n";
+    }
+
+    RunJournal journal;
+    std::string error;
+    CHECK(journal.create(directory + "/run", batch, "", platforms, error));
+    for (size_t id = 1; id <= 21; id++) {
+        std::string name = "user" + std::to_string(id);
+        CheckOutcome dead = verdict(platforms[0], name, 0);
+        dead.error = CURLE_COULDNT_CONNECT;
+        journal.record(id, dead);
+        journal.record(id, verdict(platforms[1], name, 200));
+        journal.record(id, verdict(platforms[2], name, 404));
+        journal.finish(id, name);
+    }
+    CHECK(journal.checkpoint().size() == 21);
+    CHECK(journal.close());
+
+    std::ifstream file(directory + "/run/journal.ygj", std::ios::binary | std::ios::ate);
+    CHECK((size_t)file.tellg() == sizeof(JournalHeader) + 21 * sizeof(JournalRecord));
+
+    RunJournal resumed;
+    CHECK(resumed.resume(directory + "/run", platforms, error));
+    CHECK(resumed.checkpoint().size() == 21);
+    CHECK(resumed.checkpoint().uncheckedCount(20) == 1);
+    CHECK(resumed.journaledChecks() == 0);
+    CHECK(resumed.missingCount() == 21);
+    resumed.close();
+
+    std::remove(batch.c_str());
+}
+
+static void testDamagedJournal(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string batch = interruptedRun(directory, platforms);
+    std::string journalFile = directory + "/run/journal.ygj";
+
+    // A record with a bad checksum, then a torn append
+    {
+        JournalRecord record;
+        memset(&record, 0, sizeof(record));
+        record.user = 1;
+        record.platform = 1;
+        record.kind = JOURNAL_VERDICT;
+        record.status = 200;
+        record.found = 1;
+        record.checksum = record.computeChecksum() ^ 1;
+        std::ofstream file(journalFile, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record) / 2);
+    }
+
+    RunJournal journal;
+    std::string error;
+    CHECK(journal.resume(directory + "/run", platforms, error));
+    CHECK(journal.journaledChecks() == 1);
+    CheckOutcome outcome;
+    CHECK(!journal.recall(1, verdict(platforms[1], "bob", 0).job, outcome));
+    journal.close();
+
+    // A journal that is not one is an error, not an empty run
+    std::ofstream(journalFile, std::ios::trunc) << "not a journal, just text";
+    RunJournal unreadable;
+    CHECK(!unreadable.resume(directory + "/run", platforms, error));
+
+    std::remove(batch.c_str());
+}
+
+static void testDamagedCheckpoint(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string batch = interruptedRun(directory, platforms);
+    std::string checkpoint = directory + "/run/checkpoint.ygr";
+
+    std::ifstream in(checkpoint, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream(checkpoint, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 3);
+
+    RunJournal journal;
+    std::string error;
+    CHECK(!journal.resume(directory + "/run", platforms, error));
+    CHECK(error.find("truncated") != std::string::npos);
+
+    std::remove(batch.c_str());
+}
+
+// The run no longer matches a changed platform database
+static void testChangedPlatforms(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string batch = interruptedRun(directory, platforms);
+
+    PlatformTable changed;
+    std::string error;
+    CHECK(changed.loadText("yougoldberg-platforms\t1\nAlpha\thttps://alpha.example/u/%s\n", "<test>", error));
+    RunJournal journal;
+    CHECK(!journal.resume(directory + "/run", changed, error));
+
+    std::remove(batch.c_str());
+}
+
+static void cleanRun(const std::string& directory) {
+    for (const char* file : {"/run/run.tsv", "/run/checkpoint.ygr", "/run/journal.ygj"}) {
+        std::remove((directory + file).c_str());
+    }
+    rmdir((directory + "/run").c_str());
+}
+
+int main() {
+    std::string directory = scratchDirectory();
+    testResume(directory);
+    cleanRun(directory);
+    testFailedChecks(directory);
+    cleanRun(directory);
+    testCompaction(directory);
+    cleanRun(directory);
+    testDamagedJournal(directory);
+    cleanRun(directory);
+    testDamagedCheckpoint(directory);
+    cleanRun(directory);
+    testChangedPlatforms(directory);
+    cleanRun(directory);
+    rmdir(directory.c_str());
+    return report("journal");
+}
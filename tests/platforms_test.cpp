@@ -0,0 +1,62 @@
+// Platform::normalize(): the name a site resolves a username to
+#include <string>
+#include "platforms.hpp"
+#include "check.hpp"
+
+static PlatformTable load(const std::string& lines) {
+    PlatformTable platforms;
+    std::string error;
+    bool ok = platforms.loadText("yougoldberg-platforms\t1\n" + lines, "<test>", error);
+    if (!ok) std::cerr << error << "\n";
+    CHECK(ok);
+    return platforms;
+}
+
+static void testRules() {
+    PlatformTable platforms = load("Site\thttps://site.example/%s\tcase=insensitive\tignore=.\tchars=a-z0-9_\tlength=3-10\n");
+    CHECK(platforms.size() == 1);
+    const Platform& site = platforms[0];
+
+    std::string name;
+    CHECK(site.normalize("John.Doe", name) && name == "johndoe");
+    CHECK(site.normalize("j_d", name) && name == "j_d");
+    CHECK(!site.normalize("j.d", name));            // too short once the dot is dropped
+    CHECK(!site.normalize("averyverylongname", name));
+    CHECK(!site.normalize("john-doe", name));       // '-' is not allowed
+}
+
+static void testCaseSensitive() {
+    PlatformTable platforms = load("Site\thttps://site.example/u/%s\n");
+    std::string name;
+    CHECK(platforms[0].normalize("John.Doe", name) && name == "John.Doe");
+    CHECK(platforms[0].normalize("", name) && name.empty());
+}
+
+// A username in the host part must be a DNS label
+static void testHostLabel() {
+    PlatformTable platforms = load("Blog\thttps://%s.blog.example\n");
+    const Platform& blog = platforms[0];
+    CHECK(blog.host == "blog.example");
+
+    std::string name;
+    CHECK(blog.normalize("JohnDoe", name) && name == "johndoe");
+    CHECK(blog.normalize("john-doe", name) && name == "john-doe");
+    CHECK(!blog.normalize("john_doe", name));
+    CHECK(!blog.normalize("john.doe", name));
+    CHECK(!blog.normalize(std::string(64, 'a'), name));
+}
+
+// Attributes given explicitly override the DNS label defaults
+static void testHostLabelOverride() {
+    PlatformTable platforms = load("Blog\thttps://%s.blog.example\tchars=a-z0-9_\n");
+    std::string name;
+    CHECK(platforms[0].normalize("John_Doe", name) && name == "john_doe");
+}
+
+int main() {
+    testRules();
+    testCaseSensitive();
+    testHostLabel();
+    testHostLabelOverride();
+    return report("platforms");
+}
@@ -0,0 +1,153 @@
+// ResultStore: the binary result file round-trips and damaged files are
+// rejected instead of read out of bounds
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include "results.hpp"
+#include "check.hpp"
+
+// 70 platforms, so a found-bitset spans two words
+static PlatformTable platformTable() {
+    std::string text = "yougoldberg-platforms\t1\n";
+    for (int i = 0; i < 70; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "Site%02d", i);
+        text += std::string(name) + "\thttps://" + name + ".example/%s\n";
+    }
+    PlatformTable platforms;
+    std::string error;
+    CHECK(platforms.loadText(text, "<test>", error));
+    return platforms;
+}
+
+static ResultStore sampleStore(const PlatformTable& platforms) {
+    ResultStore store(platforms);
+    store.add("alice", {{65, 200}, {3, 301}, {0, 200}}, 0);
+    store.add("bob", {}, 2);
+    store.add("carol", {{69, 200}}, 0);
+    return store;
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string& path, const std::string& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+static void testRoundTrip(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string path = directory + "/results.ygr";
+    CHECK(sampleStore(platforms).save(path));
+
+    ResultStore loaded;
+    std::string error;
+    CHECK(loaded.load(path, error));
+    CHECK(loaded.size() == 3);
+    CHECK(loaded.platformCount() == 70);
+    CHECK(loaded.username(0) == "alice" && loaded.username(1) == "bob" && loaded.username(2) == "carol");
+    CHECK(loaded.uncheckedCount(1) == 2);
+
+    std::vector<ResultStore::Hit> hits;
+    loaded.hits(0, hits);
+    CHECK(hits.size() == 3);
+    CHECK(hits.size() == 3 && hits[0].platform == 0 && hits[1].platform == 3 && hits[1].status == 301 && hits[2].platform == 65);
+    loaded.hits(1, hits);
+    CHECK(hits.empty());
+    loaded.hits(2, hits);
+    CHECK(hits.size() == 1 && hits[0].platform == 69);
+    CHECK(loaded.url(69, "carol") == "https://Site69.example/carol");
+    std::remove(path.c_str());
+}
+
+static void testEmptyStore(const std::string& directory) {
+    std::string path = directory + "/empty.ygr";
+    CHECK(ResultStore(platformTable()).save(path));
+    ResultStore loaded;
+    std::string error;
+    CHECK(loaded.load(path, error));
+    CHECK(loaded.size() == 0);
+    std::remove(path.c_str());
+}
+
+static void testCorrupt(const std::string& directory) {
+    PlatformTable platforms = platformTable();
+    std::string path = directory + "/results.ygr";
+    CHECK(sampleStore(platforms).save(path));
+    std::string good = readFile(path);
+    ResultStore loaded;
+    std::string error;
+
+    // Truncations anywhere in the file are caught, down to a single byte
+    std::vector<size_t> sizes = {0, sizeof(ResultFileHeader) - 1, sizeof(ResultFileHeader), good.size() / 2};
+    for (size_t cut = 1; cut <= 48; cut += 3) sizes.push_back(good.size() - cut);
+    for (size_t size : sizes) {
+        writeFile(path, good.substr(0, size));
+        CHECK(!loaded.load(path, error));
+    }
+
+    std::string bad = good;
+    bad[0] = 'X';
+    writeFile(path, bad);
+    CHECK(!loaded.load(path, error));
+
+    // A platform count no file of this size can hold
+    bad = good;
+    uint32_t platformCount = 0xFFFFFFFF;
+    memcpy(&bad[offsetof(ResultFileHeader, platforms)], &platformCount, sizeof(platformCount));
+    writeFile(path, bad);
+    CHECK(!loaded.load(path, error));
+    CHECK(error.find("truncated") != std::string::npos);
+
+    // A platform table cut off inside a template
+    bad = good.substr(0, sizeof(ResultFileHeader) + 10);
+    writeFile(path, bad);
+    CHECK(!loaded.load(path, error));
+    CHECK(error.find("truncated") != std::string::npos);
+
+    // More statuses than the bitsets have hits
+    bad = good;
+    uint64_t hits = 6;
+    memcpy(&bad[offsetof(ResultFileHeader, hits)], &hits, sizeof(hits));
+    bad += std::string(2 * sizeof(uint16_t), '\0');
+    writeFile(path, bad);
+    CHECK(!loaded.load(path, error));
+
+    // Statuses with no username at all
+    ResultStore empty(platforms);
+    CHECK(empty.save(path));
+    bad = readFile(path);
+    hits = 1;
+    memcpy(&bad[offsetof(ResultFileHeader, hits)], &hits, sizeof(hits));
+    bad += std::string(sizeof(uint16_t), '\0');
+    writeFile(path, bad);
+    CHECK(!loaded.load(path, error));
+
+    // A found bit past the last platform; carol's hit on platform 69 is
+    // moved to bit 70 of her bitset
+    bad = good;
+    size_t bitsAt = good.size() - 4 * sizeof(uint16_t) - 3 * sizeof(uint16_t) - 3 * sizeof(uint64_t) - 6 * sizeof(uint64_t);
+    uint64_t word = 0;
+    memcpy(&word, &bad[bitsAt + 5 * sizeof(uint64_t)], sizeof(word));
+    CHECK(word == 1ULL << 5);
+    word = 1ULL << 6;
+    memcpy(&bad[bitsAt + 5 * sizeof(uint64_t)], &word, sizeof(word));
+    writeFile(path, bad);
+    CHECK(!loaded.load(path, error));
+
+    CHECK(!loaded.load(directory + "/missing.ygr", error));
+    std::remove(path.c_str());
+}
+
+int main() {
+    std::string directory = scratchDirectory();
+    testRoundTrip(directory);
+    testEmptyStore(directory);
+    testCorrupt(directory);
+    rmdir(directory.c_str());
+    return report("results");
+}
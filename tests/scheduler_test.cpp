@@ -0,0 +1,98 @@
+// HostScheduler: round-robin across hosts and the per-host token bucket
+#include <string>
+#include <vector>
+#include <map>
+#include "scheduler.hpp"
+#include "check.hpp"
+
+using Clock = HostScheduler::Clock;
+
+static CheckJob job(const std::string& host, size_t user) {
+    CheckJob job;
+    job.host = host;
+    job.url = "https://" + host + "/" + std::to_string(user);
+    job.user = user;
+    return job;
+}
+
+// A host with a long queue must not hold back hosts queued after it
+static void testFairness() {
+    HostScheduler scheduler(1000.0, 1000.0, 100);
+    for (size_t i = 0; i < 10; i++) scheduler.push(job("a.example", i));
+    for (size_t i = 0; i < 2; i++) scheduler.push(job("b.example", i));
+    for (size_t i = 0; i < 2; i++) scheduler.push(job("c.example", i));
+
+    std::vector<std::string> order;
+    CheckJob next;
+    Clock::duration wait = Clock::duration::max();
+    while (scheduler.pop(next, Clock::now(), wait)) {
+        order.push_back(next.host);
+        scheduler.release();
+    }
+
+    CHECK(order.size() == 14);
+    CHECK(scheduler.pending() == 0);
+    std::vector<std::string> expected = {"a.example", "b.example", "c.example", "a.example", "b.example", "c.example"};
+    CHECK(std::vector<std::string>(order.begin(), order.begin() + 6) == expected);
+}
+
+// Over a simulated second, a host gets its burst plus `rate` requests and
+// never more; another host's budget is independent
+static void testRate() {
+    HostScheduler scheduler(10.0, 2.0, 100);
+    for (size_t i = 0; i < 100; i++) scheduler.push(job("a.example", i));
+    for (size_t i = 0; i < 100; i++) scheduler.push(job("b.example", i));
+
+    Clock::time_point start = Clock::now();
+    std::map<std::string, int> sent;
+    CheckJob next;
+    for (int ms = 0; ms <= 1000; ms++) {
+        Clock::time_point now = start + std::chrono::milliseconds(ms);
+        Clock::duration wait = Clock::duration::max();
+        while (scheduler.pop(next, now, wait)) {
+            sent[next.host]++;
+            scheduler.release();
+        }
+    }
+    CHECK(sent["a.example"] >= 11 && sent["a.example"] <= 12);
+    CHECK(sent["b.example"] >= 11 && sent["b.example"] <= 12);
+}
+
+// When the bucket is empty, pop() reports how long until the next token
+static void testWait() {
+    HostScheduler scheduler(4.0, 1.0, 100);
+    scheduler.push(job("a.example", 0));
+    scheduler.push(job("a.example", 1));
+
+    Clock::time_point now = Clock::now();
+    CheckJob next;
+    Clock::duration wait = Clock::duration::max();
+    CHECK(scheduler.pop(next, now, wait));
+    scheduler.release();
+    CHECK(!scheduler.pop(next, now, wait));
+    double seconds = std::chrono::duration<double>(wait).count();
+    CHECK(seconds > 0.2 && seconds <= 0.26);
+    CHECK(scheduler.pop(next, now + wait, wait));
+}
+
+static void testInFlightCap() {
+    HostScheduler scheduler(1000.0, 1000.0, 2);
+    for (size_t i = 0; i < 3; i++) scheduler.push(job("host" + std::to_string(i), i));
+
+    CheckJob next;
+    Clock::duration wait = Clock::duration::max();
+    CHECK(scheduler.pop(next, Clock::now(), wait));
+    CHECK(scheduler.pop(next, Clock::now(), wait));
+    CHECK(!scheduler.pop(next, Clock::now(), wait));
+    scheduler.release();
+    CHECK(scheduler.pop(next, Clock::now(), wait));
+    CHECK(scheduler.active() == 2);
+}
+
+int main() {
+    testFairness();
+    testRate();
+    testWait();
+    testInFlightCap();
+    return report("scheduler");
+}
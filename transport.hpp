@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "check_job.hpp"
+#include "detect.hpp"
+
+// What a transport reports for one finished request
+struct TransportResult {
+    size_t slot;            // as passed to Transport::start()
+    CURLcode error;         // CURLE_OK when a response was received
+    long responseCode;      // HTTP status, 0 on transport failure
+    std::string finalURL;   // after redirects
+    double seconds;         // total request time
+    TransferTiming timing;
+    long httpVersion;       // CURL_HTTP_VERSION_* the server answered with, 0 if unknown
+    long localPort;         // tells connections apart, 0 if unknown
+    long newConnections;    // connections opened for this request
+};
+
+// Moves CheckJobs over the wire for CheckEngine. A transport owns a fixed
+// number of slots (one per concurrent request); the engine decides what
+// runs in which slot, the transport only performs it. Response bodies are
+// streamed into the slot's BodyScanner, and a transport may stop reading
+// as soon as the scanner has a verdict.
+class Transport {
+public:
+    virtual ~Transport() {}
+
+    virtual bool ready() const = 0;
+    virtual size_t slots() const = 0;
+
+    // Begin `job` in `slot`. `scanner` must stay valid until the slot
+    // completes or is cancelled.
+    virtual void start(size_t slot, const CheckJob& job, long timeoutMs, BodyScanner* scanner) = 0;
+
+    // Abandon the request in `slot` without reporting it
+    virtual void cancel(size_t slot) = 0;
+
+    // Make progress without blocking and append finished requests to
+    // `done`. Returns the number of requests still running.
+    virtual int perform(std::vector<TransportResult>& done) = 0;
+
+    // Block until a running request may have progressed, at most `waitMs`
+    virtual void wait(int waitMs) = 0;
+
+    // Make a wait() in progress return early. Safe to call from any thread.
+    virtual void wakeup() {}
+};
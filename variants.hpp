@@ -0,0 +1,110 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cctype>
+#include <sstream>
+#include <algorithm>
+
+// Which spellings of an identity --variants generates, from --variant-rules:
+//   separators[=CHARS]  join the name's parts with each of CHARS and with
+//                       nothing (default CHARS: ._-)
+//   case                each part lowercase, Capitalized and UPPERCASE
+//   reverse             also the parts in reverse order (doe.john)
+struct VariantRules {
+    bool separators = true;
+    std::string separatorChars = "._-";
+    bool caseForms = true;
+    bool reverse = false;
+
+    bool parse(const std::string& text, std::string& error) {
+        separators = caseForms = reverse = false;
+        std::stringstream split(text);
+        for (std::string rule; std::getline(split, rule, ',');) {
+            if (rule == "separators") {
+                separators = true;
+            } else if (rule.compare(0, 11, "separators=") == 0) {
+                separators = true;
+                separatorChars = rule.substr(11);
+            } else if (rule == "case") {
+                caseForms = true;
+            } else if (rule == "reverse") {
+                reverse = true;
+            } else {
+                error = "unknown variant rule '" + rule + "' (expected separators, case or reverse)";
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Parts of a name: split at '.', '_', '-' and spaces, and where a lowercase
+// letter is followed by an uppercase one ("JohnDoe" -> John, Doe)
+inline std::vector<std::string> splitNameParts(const std::string& name) {
+    std::vector<std::string> parts;
+    std::string part;
+    for (size_t i = 0; i < name.size(); i++) {
+        char c = name[i];
+        if (c == '.' || c == '_' || c == '-' || c == ' ') {
+            if (!part.empty()) parts.push_back(part);
+            part.clear();
+            continue;
+        }
+        if (!part.empty() && isupper((unsigned char)c) && islower((unsigned char)part.back())) {
+            parts.push_back(part);
+            part.clear();
+        }
+        part += c;
+    }
+    if (!part.empty()) parts.push_back(part);
+    return parts;
+}
+
+// Every spelling of `identity` the rules produce, the identity itself
+// first, without duplicates
+inline std::vector<std::string> expandVariants(const std::string& identity, const VariantRules& rules) {
+    std::vector<std::string> variants = {identity};
+    auto add = [&](const std::string& variant) {
+        if (!variant.empty() && std::find(variants.begin(), variants.end(), variant) == variants.end()) {
+            variants.push_back(variant);
+        }
+    };
+
+    std::vector<std::vector<std::string>> orders = {splitNameParts(identity)};
+    if (rules.reverse && orders[0].size() > 1) {
+        orders.push_back(std::vector<std::string>(orders[0].rbegin(), orders[0].rend()));
+    }
+
+    // Without the separators rule, parts are rejoined the way the identity joins them
+    std::vector<std::string> joiners;
+    if (rules.separators) {
+        for (char c : rules.separatorChars) joiners.push_back(std::string(1, c));
+        joiners.push_back("");
+    } else {
+        size_t at = identity.find_first_of("._- ");
+        joiners.push_back(at == std::string::npos ? "" : identity.substr(at, 1));
+    }
+
+    enum Form { AS_IS, LOWER, CAPITALIZED, UPPER };
+    std::vector<Form> forms = {AS_IS};
+    if (rules.caseForms) forms.insert(forms.end(), {LOWER, CAPITALIZED, UPPER});
+
+    for (const auto& parts : orders) {
+        for (Form form : forms) {
+            for (const auto& joiner : joiners) {
+                std::string variant;
+                for (size_t i = 0; i < parts.size(); i++) {
+                    if (i > 0) variant += joiner;
+                    for (size_t j = 0; j < parts[i].size(); j++) {
+                        char c = parts[i][j];
+                        if (form == LOWER || (form == CAPITALIZED && j > 0)) c = (char)tolower((unsigned char)c);
+                        if (form == UPPER || (form == CAPITALIZED && j == 0)) c = (char)toupper((unsigned char)c);
+                        variant += c;
+                    }
+                }
+                add(variant);
+            }
+        }
+    }
+    return variants;
+}